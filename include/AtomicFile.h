@@ -0,0 +1,35 @@
+#ifndef ATOMIC_FILE_H
+#define ATOMIC_FILE_H
+
+#include <string>
+#include <cstddef>
+
+/**
+ * @brief 原子文件替换：先完整写入同目录下的临时文件并刷到磁盘，再改名覆盖原文件。
+ *
+ * 任意时刻崩溃，原文件要么仍是旧内容，要么已是完整的新内容；
+ * 残留的临时文件（path + ".tmp"）说明上次写入被中断，可直接删除。
+ */
+class AtomicFile {
+public:
+    static const char* const TEMP_SUFFIX;
+
+    // 一次写入全部内容并原子替换 path
+    static bool write(const std::string& path, const char* data, size_t size);
+    static bool write(const std::string& path, const std::string& content);
+
+    // 已由调用方写好并关闭的临时文件：刷盘后改名覆盖 path
+    static bool commit(const std::string& tempPath, const std::string& path);
+
+    // 追加到文件末尾并刷盘（文件不存在时创建），用于日志的批量提交。
+    // written 不为空时返回实际写入的字节数：失败后只需重试剩余部分，不会重复写入已写入的内容
+    static bool appendSynced(const std::string& path, const char* data, size_t size, size_t* written = nullptr);
+
+    // 临时文件路径
+    static std::string tempPathOf(const std::string& path);
+
+    // 删除 path 对应的残留临时文件，返回是否存在残留
+    static bool recover(const std::string& path);
+};
+
+#endif // ATOMIC_FILE_H
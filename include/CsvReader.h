@@ -0,0 +1,86 @@
+#ifndef CSV_READER_H
+#define CSV_READER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "Money.h"
+#include "Date.h"
+
+class StringDictionary;
+
+/**
+ * @brief CSV字段切片，直接指向原始缓冲区，不拥有内存
+ */
+struct CsvField {
+    const char* data;   // 字段内容（已去掉外层引号）
+    size_t size;
+    bool escaped;       // 内容中含有需要还原的双引号 ""
+
+    CsvField() : data(nullptr), size(0), escaped(false) {}
+
+    bool empty() const { return size == 0; }
+    bool equals(const char* text) const;
+
+    // 还原为字符串（只在这里分配内存）
+    std::string toString() const;
+    void assignTo(std::string& out) const;
+
+    // 数值与日期转换（不抛异常，整个字段必须是一个值，允许千分位逗号）
+    ParseStatus parseInt(int& out) const;
+    ParseStatus parseAmount(Money& out) const;
+    ParseStatus parseDate(Date& out) const;
+    // 在字典中驻留字段文本，未转义的字段不创建临时字符串；字典已满时返回 TooManyStrings
+    ParseStatus intern(StringDictionary& dictionary, uint32_t& out) const;
+};
+
+/**
+ * @brief 在内存缓冲区上逐条切分CSV记录，不为字段创建临时字符串
+ *
+ * 批量加载、日志重放和单条记录解析（fromCSV）共用同一套切分逻辑。
+ */
+class CsvReader {
+private:
+    const char* cur;
+    const char* last;
+    size_t nextLine;    // cur 所在的行号
+    size_t recordLine;  // 上一条返回记录的起始行号
+
+public:
+    // 单条记录最多保存的字段切片数，多余字段只计数
+    static const size_t MAX_FIELDS = 16;
+
+    CsvReader(const char* begin, const char* end);
+
+    // 读取下一条非空记录，fieldCount 为记录中的实际字段数；到达末尾时返回false
+    bool next(CsvField* fields, size_t& fieldCount);
+
+    // 上一条记录的起始行号（从1开始，相对于 begin）
+    size_t line() const { return recordLine; }
+
+    // 未加引号的千分位金额（如 8,000.00）会被逗号拆成多个字段。字段数多于 expected 时，
+    // 若从 index 开始的字段正好构成一个千分位数字，把它们合并回一个切片；返回减少的字段数
+    static size_t joinGroupedNumber(CsvField* fields, size_t count, size_t index, size_t expected);
+
+    // 将缓冲区切成约 parts 块，切分点都落在引号外的换行之后；返回各块起点及末尾
+    static std::vector<const char*> splitRecords(const char* begin, const char* end, size_t parts);
+
+    // 找到 [begin, end) 中第一个逗号、引号、换行或回车，没有时返回 end；
+    // 支持时用 SSE2/AVX2 一次比较16/32字节
+    static const char* findSpecial(const char* begin, const char* end);
+};
+
+/**
+ * @brief CSV字段转义，基础文件、日志和单条记录序列化共用
+ */
+class CsvWriter {
+public:
+    // 字段含有逗号、引号或换行时需要加引号
+    static bool needsQuoting(const char* data, size_t size);
+
+    // 把字段追加到 out，必要时加引号并把 " 转义为 ""
+    static void appendField(std::string& out, const std::string& field);
+    static std::string escapeField(const std::string& field);
+};
+
+#endif // CSV_READER_H
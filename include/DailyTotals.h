@@ -0,0 +1,53 @@
+#ifndef DAILY_TOTALS_H
+#define DAILY_TOTALS_H
+
+#include <vector>
+#include <cstdint>
+#include "Money.h"
+#include "Date.h"
+
+/**
+ * @brief 按天累计的金额，分块存放，只覆盖实际出现过的日期范围
+ *
+ * 以 Date::getDayNumber() 为天数，每 BLOCK_DAYS 天一块：块内逐日的金额只在块中有记录时才分配，
+ * 所有分配的块连续存放在同一个数组中；各块的合计放在一个树状数组（Fenwick 树）中。覆盖范围随最早和最晚的日期扩展，
+ * 从未使用过的实例不占内存，只有几条记录的分类也只占几个块。
+ * 单条记录的增减为 O(log 块数)，任意日期区间的合计为 O(log 块数 + BLOCK_DAYS)，与记录条数无关。
+ */
+class DailyTotals {
+public:
+    static const int BLOCK_DAYS = 32;
+
+    DailyTotals();
+
+    void clear();
+    // 在 date 当天加上 cents（删除记录时传入相反数）
+    void add(Date date, int64_t cents);
+    // 批量加载时先 append 按天累加，再由 finish 一次性整理成树状数组，整体 O(记录数 + 天数)
+    void append(Date date, int64_t cents);
+    void finish();
+
+    // 截至 date（含当天）的累计金额
+    Money totalThrough(Date date) const;
+    // [startDate, endDate] 区间内的合计，startDate 晚于 endDate 时为0
+    Money totalBetween(Date startDate, Date endDate) const;
+
+private:
+    static const uint32_t NO_BLOCK = UINT32_MAX;
+
+    int firstBlock;                     // blocks[0] 对应的块号
+    std::vector<uint32_t> blocks;       // 覆盖范围内每块的逐日金额在 days 中的起点，块中没有记录时为 NO_BLOCK
+    std::vector<int64_t> days;          // 已分配的块，每块 BLOCK_DAYS 天
+    std::vector<int64_t> blockTree;     // 各块合计的树状数组，下标从1开始；覆盖范围扩展后清空待重建
+
+    static int dayCount();
+    // 超出 Date::MIN_YEAR ~ Date::MAX_YEAR 的日期计入首尾两天，保证总计不丢
+    static int clampDay(Date date);
+    // 当天所在块的逐日数组中的位置，必要时扩展覆盖范围并分配该块
+    int64_t& slotOf(int day);
+    void rebuildTree();
+    // 第 0 ~ day 天的合计，day 为负时为0
+    int64_t prefix(int day) const;
+};
+
+#endif // DAILY_TOTALS_H
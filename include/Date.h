@@ -0,0 +1,68 @@
+#ifndef DATE_H
+#define DATE_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "NumberParser.h"
+
+/**
+ * @brief 日期类型，打包为32位整数 yyyymmdd
+ *
+ * 数值大小顺序与日期先后一致，比较、排序和范围过滤都是整数运算；
+ * 年、季度、月的提取只做除法，不分配内存。默认构造的日期为空（0）。
+ */
+class Date {
+private:
+    uint32_t packed;
+
+    explicit Date(uint32_t packed) : packed(packed) {}
+
+public:
+    // 可接受的年份范围
+    static const int MIN_YEAR = 1900;
+    static const int MAX_YEAR = 2100;
+
+    Date() : packed(0) {}
+
+    // 直接使用打包值（来自二进制快照等已校验的来源），不再校验
+    static Date fromPacked(uint32_t packed) { return Date(packed); }
+    // 年月日不合法时返回空日期
+    static Date fromParts(int year, int month, int day);
+    static Date today();
+
+    // 解析 YYYY-MM-DD（允许首尾空格），规则与 InputHelper::isValidDate 相同，不抛异常
+    static ParseStatus parse(const char* data, size_t size, Date& out);
+    static ParseStatus parse(const std::string& text, Date& out);
+
+    static bool isLeapYear(int year);
+    static int getDaysInMonth(int year, int month);
+    static bool isValid(int year, int month, int day);
+
+    bool isEmpty() const { return packed == 0; }
+    uint32_t getPacked() const { return packed; }
+
+    int getYear() const { return static_cast<int>(packed / 10000); }
+    int getMonth() const { return static_cast<int>(packed / 100 % 100); }
+    int getDay() const { return static_cast<int>(packed % 100); }
+    int getQuarter() const { return (getMonth() + 2) / 3; }
+    // 年月键 yyyymm，可直接用于按月分组和排序
+    uint32_t getYearMonth() const { return packed / 100; }
+    // 自 MIN_YEAR 年1月1日起的天数（当天为0），用于按天编号的数组下标
+    int getDayNumber() const;
+
+    // YYYY-MM-DD，空日期为空串
+    std::string toString() const;
+    void appendTo(std::string& out) const;
+    // 年月键格式化为 YYYY-MM
+    static std::string formatYearMonth(uint32_t yearMonth);
+
+    bool operator==(Date other) const { return packed == other.packed; }
+    bool operator!=(Date other) const { return packed != other.packed; }
+    bool operator<(Date other) const { return packed < other.packed; }
+    bool operator<=(Date other) const { return packed <= other.packed; }
+    bool operator>(Date other) const { return packed > other.packed; }
+    bool operator>=(Date other) const { return packed >= other.packed; }
+};
+
+#endif // DATE_H
@@ -0,0 +1,88 @@
+#ifndef DATE_INDEX_H
+#define DATE_INDEX_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief 按 (日期, ID) 排序的槽位索引
+ *
+ * 条目分块存放，每块是一个有序数组，块满时一分为二。插入和删除只移动一块内的条目，
+ * 按日期范围查找是两次二分查找，之后沿块顺序遍历即可，不需要复制和排序。
+ */
+class DateIndex {
+public:
+    struct Entry {
+        uint32_t date;  // 打包日期 yyyymmdd
+        int id;
+        uint32_t slot;  // 记录在列式存储中的槽位
+    };
+
+    /**
+     * @brief 顺序遍历的位置，指向某一块中的某个条目
+     */
+    class Iterator {
+    public:
+        Iterator() : owner(nullptr), block(0), offset(0) {}
+        const Entry& operator*() const { return owner->blocks[block][offset]; }
+        const Entry* operator->() const { return &owner->blocks[block][offset]; }
+        Iterator& operator++() {
+            if (++offset == owner->blocks[block].size()) { ++block; offset = 0; }
+            return *this;
+        }
+        Iterator& operator--() {
+            if (offset == 0) { --block; offset = owner->blocks[block].size(); }
+            --offset;
+            return *this;
+        }
+        bool operator==(const Iterator& other) const { return block == other.block && offset == other.offset; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class DateIndex;
+        Iterator(const DateIndex* owner, size_t block, size_t offset) : owner(owner), block(block), offset(offset) {}
+        const DateIndex* owner;
+        size_t block;
+        size_t offset;
+    };
+
+    DateIndex();
+
+    void clear();
+    // 用一批条目重建索引（无需预先排序）
+    void build(std::vector<Entry> entries);
+    void insert(const Entry& entry);
+    bool erase(uint32_t date, int id);
+    // 记录搬到了新的槽位（删除时的末尾补位），日期和ID不变
+    bool moveSlot(uint32_t date, int id, uint32_t slot);
+
+    size_t size() const { return count; }
+    Iterator begin() const { return Iterator(this, 0, 0); }
+    Iterator end() const { return Iterator(this, blocks.size(), 0); }
+    // 第一个日期不早于 date 的位置
+    Iterator lowerBound(uint32_t date) const;
+    // 第一个日期晚于 date 的位置
+    Iterator upperBound(uint32_t date) const;
+    // [first, last) 之间的条目数，只按块累加，不逐条遍历
+    size_t distance(Iterator first, Iterator last) const;
+    // 从 it 向后移动 n 个条目，最多到 limit；整块跳过，不逐条遍历
+    Iterator advance(Iterator it, size_t n, Iterator limit) const;
+
+private:
+    static const size_t BLOCK_SIZE = 512;
+
+    std::vector<std::vector<Entry>> blocks;
+    size_t count;
+
+    static bool less(const Entry& a, uint32_t date, int id) {
+        return a.date != date ? a.date < date : a.id < id;
+    }
+    // 键 (date, id) 所在或应插入的块
+    size_t findBlock(uint32_t date, int id) const;
+    Iterator locate(uint32_t date, int id) const;
+    // 把位置规范化：块末尾视为下一块的开头
+    Iterator normalize(size_t block, size_t offset) const;
+};
+
+#endif // DATE_INDEX_H
@@ -3,6 +3,8 @@
 
 #include <string>
 #include <vector>
+#include "Money.h"
+#include "Date.h"
 
 /**
  * @brief 显示辅助类，提供格式化输出功能
@@ -24,6 +26,7 @@ public:
     static void printTableRow(const std::vector<std::string>& values,
                                const std::vector<int>& widths);
     static void printTableSeparator(const std::vector<int>& widths);
+    static void printTableFooter(const std::vector<int>& widths);
     
     // 消息输出
     static void printMessage(const std::string& message, bool isError = false);
@@ -32,12 +35,14 @@ public:
     static void printInfo(const std::string& message);
     
     // 格式化
-    static std::string formatAmount(double amount);
-    static std::string formatDate(const std::string& date);
+    static std::string formatAmount(Money amount);
+    static std::string formatDate(Date date);
     static std::string formatPercentage(double percentage);
     static std::string padRight(const std::string& str, int width);
     static std::string padLeft(const std::string& str, int width);
     static std::string center(const std::string& str, int width);
+    // 制表符等多字节字符不能放进 char，按字符串重复 count 次
+    static std::string repeat(const std::string& unit, int count);
     
     // 颜色支持（Windows控制台）
     static void setColor(int color);
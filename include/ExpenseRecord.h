@@ -2,28 +2,39 @@
 #define EXPENSE_RECORD_H
 
 #include "Record.h"
+#include "NumberParser.h"
+
+struct CsvField;
 
 /**
  * @brief 支出记录类，继承自Record基类
  */
 class ExpenseRecord : public Record {
 private:
-    std::string payee;  // 支出对象（如：超市、餐厅、水电费）
+    uint32_t payee;     // 支出对象（如：超市、餐厅）在 StringDictionary::parties() 中的 ID
 
 public:
     // 构造函数
     ExpenseRecord();
-    ExpenseRecord(int id, const std::string& date, double amount,
+    ExpenseRecord(int id, Date date, Money amount,
                   const std::string& category, const std::string& payee,
                   const std::string& description);
 
     // Getter/Setter
-    std::string getPayee() const;
+    const std::string& getPayee() const;
+    uint32_t getPayeeId() const;
     void setPayee(const std::string& payee);
+    void setPayeeId(uint32_t payeeId);
 
     // 实现基类纯虚函数
     std::string toCSV() const override;
+
+    // 把CSV行追加到 out 末尾（批量保存时共用一个缓冲区，避免逐行构造字符串流）
+    void appendCSV(std::string& out) const;
     bool fromCSV(const std::string& line) override;
+    // 从已切分的CSV字段直接构建（批量加载时使用，只为最终字段分配内存）；
+    // 失败时返回原因，failedColumn 返回出错的列（从0开始）
+    ParseStatus fromFields(const CsvField* fields, size_t count, size_t* failedColumn = nullptr);
     void display() const override;
     std::string getTypeName() const override;
 
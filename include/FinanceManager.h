@@ -3,67 +3,114 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
 #include "IncomeRecord.h"
 #include "ExpenseRecord.h"
 #include "RecordStorage.h"
+#include "RecordLedger.h"
+#include "RecordView.h"
 
 /**
  * @brief 财务管理类，提供业务逻辑功能
  */
 class FinanceManager {
 private:
-    std::vector<IncomeRecord> incomeRecords;
-    std::vector<ExpenseRecord> expenseRecords;
+    // 记录按列存放并带有ID、日期、分类和全文索引，查询返回的记录对象都是按槽位组装出来的副本
+    RecordLedger<IncomeRecord> incomeLedger;
+    RecordLedger<ExpenseRecord> expenseLedger;
     RecordStorage storage;
 
-    // 内部辅助方法
-    IncomeRecord* findIncomeById(int id);
-    ExpenseRecord* findExpenseById(int id);
-    const IncomeRecord* findIncomeById(int id) const;
-    const ExpenseRecord* findExpenseById(int id) const;
+    // 将单条修改追加到日志，必要时触发后台压缩
+    bool journalIncome(JournalOp op, const IncomeRecord& record);
+    bool journalExpense(JournalOp op, const ExpenseRecord& record);
 
 public:
     // 构造函数
     FinanceManager();
-    FinanceManager(const std::string& incomeFile, const std::string& expenseFile);
+    FinanceManager(const std::string& incomeFile, const std::string& expenseFile,
+                   const StorageOptions& options = StorageOptions());
     ~FinanceManager();
 
-    // 初始化和保存
+    // 初始化和保存（saveAll 将全部数据写回基础文件并清空日志）
     bool initialize();
     bool saveAll();
+    // 等待后台持久化线程把已提交的修改全部写入日志并刷盘
+    bool flush();
+
+    // 加载时因格式错误跳过的行
+    std::vector<LoadIssue> getLoadIssues() const;
+    size_t getSkippedRowCount() const;
 
     // 收入管理
     bool addIncome(const IncomeRecord& record);
     bool deleteIncome(int id);
     bool modifyIncome(int id, const IncomeRecord& newData);
-    IncomeRecord* getIncomeById(int id);
-    const IncomeRecord* getIncomeById(int id) const;
+    // 找到时把记录复制到 record 中；修改请使用 modifyIncome
+    bool getIncomeById(int id, IncomeRecord& record) const;
     
     // 收入查询
-    std::vector<IncomeRecord> queryIncomeByDateRange(const std::string& startDate, 
-                                                      const std::string& endDate) const;
-    std::vector<IncomeRecord> queryIncomeByCategory(const std::string& category) const;
-    std::vector<IncomeRecord> getAllIncome() const;
+    // 查询结果视图：直接引用存储，遍历时才读取字段，不复制记录；数据被修改后需重新查询
+    RecordView<IncomeRecord> viewIncome() const;
+    RecordView<IncomeRecord> viewIncomeByDateRange(Date startDate, Date endDate) const;
+    RecordView<IncomeRecord> viewIncomeByCategory(const std::string& category) const;
+    RecordView<IncomeRecord> viewIncomeByCategoryAndDateRange(const std::string& category, Date startDate, Date endDate) const;
+    RecordView<IncomeRecord> viewIncomeByKeyword(const std::string& keyword) const;
+    // 以下返回独立的记录副本；offset/limit 用于分页，只组装这一页的记录
+    std::vector<IncomeRecord> queryIncomeByDateRange(Date startDate, Date endDate,
+                                                     size_t offset = 0, size_t limit = SIZE_MAX) const;
+    std::vector<IncomeRecord> queryIncomeByCategory(const std::string& category,
+                                                    size_t offset = 0, size_t limit = SIZE_MAX) const;
+    // 分类和日期范围同时满足，只访问该分类的记录
+    std::vector<IncomeRecord> queryIncomeByCategoryAndDateRange(const std::string& category,
+                                                                Date startDate, Date endDate,
+                                                                size_t offset = 0, size_t limit = SIZE_MAX) const;
+    // 描述或收入来源中含有关键词的记录
+    std::vector<IncomeRecord> searchIncome(const std::string& keyword, size_t offset = 0, size_t limit = SIZE_MAX) const;
+    std::vector<IncomeRecord> getAllIncome(size_t offset = 0, size_t limit = SIZE_MAX) const;
     int getIncomeCount() const;
+    // 列式数据的只读访问，供统计时直接扫描
+    const RecordColumns<IncomeRecord>& getIncomeColumns() const;
+    // 随增删改同步维护的总计、月度和分类汇总
+    const LedgerTotals& getIncomeTotals() const;
 
     // 支出管理
     bool addExpense(const ExpenseRecord& record);
     bool deleteExpense(int id);
     bool modifyExpense(int id, const ExpenseRecord& newData);
-    ExpenseRecord* getExpenseById(int id);
-    const ExpenseRecord* getExpenseById(int id) const;
+    bool getExpenseById(int id, ExpenseRecord& record) const;
     
     // 支出查询
-    std::vector<ExpenseRecord> queryExpenseByDateRange(const std::string& startDate,
-                                                        const std::string& endDate) const;
-    std::vector<ExpenseRecord> queryExpenseByCategory(const std::string& category) const;
-    std::vector<ExpenseRecord> getAllExpense() const;
+    RecordView<ExpenseRecord> viewExpense() const;
+    RecordView<ExpenseRecord> viewExpenseByDateRange(Date startDate, Date endDate) const;
+    RecordView<ExpenseRecord> viewExpenseByCategory(const std::string& category) const;
+    RecordView<ExpenseRecord> viewExpenseByCategoryAndDateRange(const std::string& category, Date startDate, Date endDate) const;
+    RecordView<ExpenseRecord> viewExpenseByKeyword(const std::string& keyword) const;
+    // 以下返回独立的记录副本
+    std::vector<ExpenseRecord> queryExpenseByDateRange(Date startDate, Date endDate,
+                                                       size_t offset = 0, size_t limit = SIZE_MAX) const;
+    std::vector<ExpenseRecord> queryExpenseByCategory(const std::string& category,
+                                                      size_t offset = 0, size_t limit = SIZE_MAX) const;
+    std::vector<ExpenseRecord> queryExpenseByCategoryAndDateRange(const std::string& category,
+                                                                  Date startDate, Date endDate,
+                                                                  size_t offset = 0, size_t limit = SIZE_MAX) const;
+    // 描述或支付对象中含有关键词的记录
+    std::vector<ExpenseRecord> searchExpense(const std::string& keyword, size_t offset = 0, size_t limit = SIZE_MAX) const;
+    std::vector<ExpenseRecord> getAllExpense(size_t offset = 0, size_t limit = SIZE_MAX) const;
     int getExpenseCount() const;
+    const RecordColumns<ExpenseRecord>& getExpenseColumns() const;
+    const LedgerTotals& getExpenseTotals() const;
 
     // 统计功能
-    double getTotalIncome() const;
-    double getTotalExpense() const;
-    double getNetBalance() const;
+    Money getTotalIncome() const;
+    Money getTotalExpense() const;
+    Money getNetBalance() const;
+    // 任意日期区间（含首尾两天）的合计，O(log 天数)
+    Money getIncomeBetween(Date startDate, Date endDate) const;
+    Money getExpenseBetween(Date startDate, Date endDate) const;
+    Money getIncomeByCategoryBetween(const std::string& category, Date startDate, Date endDate) const;
+    Money getExpenseByCategoryBetween(const std::string& category, Date startDate, Date endDate) const;
+    // 截至某日（含当天）的累计结余
+    Money getBalanceAsOf(Date date) const;
     
     // ID生成
     int getNextIncomeId();
@@ -0,0 +1,43 @@
+#ifndef ID_INDEX_H
+#define ID_INDEX_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief 记录ID到槽位的哈希索引
+ *
+ * 开放寻址加线性探测，删除时把后续探测链上的条目前移（不留墓碑），
+ * 查找、插入和删除在百万级记录下都是常数时间。
+ */
+class IdIndex {
+public:
+    IdIndex();
+
+    void clear();
+    void reserve(size_t count);
+    size_t size() const { return used; }
+
+    // 插入或更新 id 对应的槽位
+    void set(int id, uint32_t slot);
+    bool find(int id, uint32_t& slot) const;
+    bool erase(int id);
+
+private:
+    static const uint32_t EMPTY = 0xFFFFFFFFu;
+
+    struct Entry {
+        int id;
+        uint32_t slot;  // EMPTY 表示空位
+    };
+
+    std::vector<Entry> entries;
+    size_t used;
+    unsigned shift;     // 64 减去表容量的位数
+
+    size_t home(int id) const;
+    void rehash(size_t capacity);
+};
+
+#endif // ID_INDEX_H
@@ -2,28 +2,39 @@
 #define INCOME_RECORD_H
 
 #include "Record.h"
+#include "NumberParser.h"
+
+struct CsvField;
 
 /**
  * @brief 收入记录类，继承自Record基类
  */
 class IncomeRecord : public Record {
 private:
-    std::string source;  // 收入来源（如：工资、奖金、投资）
+    uint32_t source;    // 收入来源（如：公司、股票账户）在 StringDictionary::parties() 中的 ID
 
 public:
     // 构造函数
     IncomeRecord();
-    IncomeRecord(int id, const std::string& date, double amount,
+    IncomeRecord(int id, Date date, Money amount,
                  const std::string& category, const std::string& source,
                  const std::string& description);
 
     // Getter/Setter
-    std::string getSource() const;
+    const std::string& getSource() const;
+    uint32_t getSourceId() const;
     void setSource(const std::string& source);
+    void setSourceId(uint32_t sourceId);
 
     // 实现基类纯虚函数
     std::string toCSV() const override;
+
+    // 把CSV行追加到 out 末尾（批量保存时共用一个缓冲区，避免逐行构造字符串流）
+    void appendCSV(std::string& out) const;
     bool fromCSV(const std::string& line) override;
+    // 从已切分的CSV字段直接构建（批量加载时使用，只为最终字段分配内存）；
+    // 失败时返回原因，failedColumn 返回出错的列（从0开始）
+    ParseStatus fromFields(const CsvField* fields, size_t count, size_t* failedColumn = nullptr);
     void display() const override;
     std::string getTypeName() const override;
 
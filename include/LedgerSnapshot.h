@@ -0,0 +1,71 @@
+#ifndef LEDGER_SNAPSHOT_H
+#define LEDGER_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "IncomeRecord.h"
+#include "ExpenseRecord.h"
+
+/**
+ * @brief 文件标记，用于判断快照是否与CSV基础文件一致
+ *
+ * 修改时间精确到纳秒（平台支持时）；identity 由 inode 和状态改变时间组成，
+ * 同一秒内改动文件而大小不变、或用 utime 还原修改时间时也会变化。
+ * 分区模式下由 combine 按分区顺序把各分区的标记混合成一个。
+ */
+struct FileStamp {
+    uint64_t size;
+    int64_t modifiedTime;   // 纳秒
+    uint64_t identity;
+
+    FileStamp() : size(0), modifiedTime(0), identity(0) {}
+    static FileStamp of(const std::string& path);
+    // 混入一个分区的名称和标记，结果与分区的顺序和名称都有关
+    void combine(const std::string& name, const FileStamp& part);
+    bool operator==(const FileStamp& other) const;
+};
+
+/**
+ * @brief 块级区间映射（zone map），记录块内日期、金额范围和分类出现情况
+ */
+struct ZoneMap {
+    uint64_t offset;        // 块数据在文件中的偏移
+    uint32_t count;         // 块内记录数
+    uint32_t minDate;       // 打包日期 yyyymmdd
+    uint32_t maxDate;
+    uint32_t reserved;
+    int64_t minAmount;      // 以分为单位
+    int64_t maxAmount;
+    uint64_t categoryBits;  // 第 i 位表示字典编号为 i 的分类出现过，编号 >= 63 的统一记在第 63 位
+};
+
+/**
+ * @brief 二进制列式快照（如 data/ledger.ffm），作为启动加载的快速路径
+ *
+ * 文件由定长文件头、字典区和收入/支出两张表组成。每张表按日期排序后切成
+ * 固定大小的块，块内按列连续存放：ID、打包日期(yyyymmdd)、分类与来源/支付对象
+ * 的字典编号、描述偏移，以及以分为单位的定点金额和描述字符串堆。文件末尾的块目录
+ * 为每块保存一个 ZoneMap：读取时按其中的偏移和条数定位各块，日期、金额范围和分类位图随格式保存。
+ * CSV 仍是交换格式，快照只是缓存。
+ */
+class LedgerSnapshot {
+public:
+    static const uint32_t VERSION = 3;
+    static const uint32_t BLOCK_RECORDS = 4096;
+
+    // 写入快照；记录中有无法打包的日期时返回false（此时不生成快照）
+    static bool write(const std::string& path,
+                      const std::vector<IncomeRecord>& income,
+                      const std::vector<ExpenseRecord>& expense,
+                      const FileStamp& incomeStamp, const FileStamp& expenseStamp);
+
+    // 读取快照；文件缺失、版本不符、内容损坏或与给定CSV标记不一致时返回false
+    static bool read(const std::string& path,
+                     std::vector<IncomeRecord>& income,
+                     std::vector<ExpenseRecord>& expense,
+                     const FileStamp& incomeStamp, const FileStamp& expenseStamp);
+
+};
+
+#endif // LEDGER_SNAPSHOT_H
@@ -0,0 +1,62 @@
+#ifndef LEDGER_TOTALS_H
+#define LEDGER_TOTALS_H
+
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+#include "Money.h"
+#include "DailyTotals.h"
+
+/**
+ * @brief 随增删改同步维护的汇总：总计、按月份和按分类的金额与条数，以及按天的累计金额
+ *
+ * 报表直接读取这里的结果，耗时只与月份数和分类数有关，与记录条数无关；
+ * 任意日期区间的合计由按天累计的 DailyTotals 给出，总的一份，本账本用到的每个分类各一份。
+ * 某个月份的记录全部删除后该月份随之消失，与重新统计的结果一致。
+ */
+class LedgerTotals {
+public:
+    struct Bucket {
+        int64_t cents;
+        size_t count;
+        Bucket() : cents(0), count(0) {}
+        Money getTotal() const { return Money::fromCents(cents); }
+    };
+
+    LedgerTotals();
+
+    void clear();
+    // date 为打包日期 yyyymmdd，category 为分类字典中的 ID
+    void add(uint32_t date, uint32_t category, int64_t cents);
+    void remove(uint32_t date, uint32_t category, int64_t cents);
+    // 批量加载时使用：先逐条 append，最后调用一次 finish
+    void append(uint32_t date, uint32_t category, int64_t cents);
+    void finish();
+
+    Money getTotal() const { return Money::fromCents(total.cents); }
+    size_t getCount() const { return total.count; }
+    // 键为年月 yyyymm，按时间顺序
+    const std::map<uint32_t, Bucket>& getMonths() const { return months; }
+    // 下标为分类 ID，没有记录的分类 count 为0
+    const std::vector<Bucket>& getCategories() const { return categories; }
+    // 按天累计的金额，用于任意日期区间的合计
+    const DailyTotals& getDaily() const { return daily; }
+    // 某个分类按天累计的金额，本账本中没有该分类的记录时返回 nullptr
+    const DailyTotals* getDailyByCategory(uint32_t category) const {
+        auto it = dailyByCategory.find(category);
+        return it != dailyByCategory.end() ? &it->second : nullptr;
+    }
+
+private:
+    Bucket total;
+    std::map<uint32_t, Bucket> months;
+    std::vector<Bucket> categories;
+    DailyTotals daily;
+    // 只为有记录的分类建立，分类 ID 来自全局字典，按 ID 开数组会为其他账本的分类占用内存
+    std::map<uint32_t, DailyTotals> dailyByCategory;
+
+    void addToBuckets(uint32_t date, uint32_t category, int64_t cents);
+};
+
+#endif // LEDGER_TOTALS_H
@@ -0,0 +1,41 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+/**
+ * @brief 只读内存映射文件，加载数据时直接在映射内存上解析，避免逐行拷贝
+ */
+class MappedFile {
+private:
+    const char* ptr;
+    size_t length;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mapHandle;
+#else
+    int fd;
+#endif
+
+public:
+    // 构造函数
+    MappedFile();
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    // 禁止拷贝
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 打开和关闭（空文件视为打开成功，大小为0）
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const;
+    const char* data() const;
+    const char* end() const;
+    size_t size() const;
+};
+
+#endif // MAPPED_FILE_H
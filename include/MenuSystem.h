@@ -9,6 +9,8 @@
  */
 class MenuSystem {
 private:
+    static const size_t PAGE_SIZE = 20;
+
     FinanceManager& manager;
     ReportGenerator reporter;
     bool running;
@@ -32,9 +34,16 @@ private:
     void modifyExpenseRecord();
     void printExpenseRecords();
 
-    // 显示记录列表
-    void displayIncomeList(const std::vector<IncomeRecord>& records);
-    void displayExpenseList(const std::vector<ExpenseRecord>& records);
+    // 前N条查询的范围：全部、日期范围或某个分类；输入的日期范围无效时返回 false
+    bool chooseIncomeScope(RecordView<IncomeRecord>& scope);
+    bool chooseExpenseScope(RecordView<ExpenseRecord>& scope);
+
+    // 显示记录列表中从 offset 开始的至多 limit 条
+    void displayIncomeList(const RecordView<IncomeRecord>& records, size_t offset = 0, size_t limit = PAGE_SIZE);
+    void displayExpenseList(const RecordView<ExpenseRecord>& records, size_t offset = 0, size_t limit = PAGE_SIZE);
+    // 分页浏览：显示第一页，之后按输入的页码翻页
+    void browseIncomeList(const RecordView<IncomeRecord>& records);
+    void browseExpenseList(const RecordView<ExpenseRecord>& records);
 
 public:
     // 构造函数
@@ -0,0 +1,55 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "NumberParser.h"
+
+/**
+ * @brief 金额类型，以分为单位的64位整数定点数
+ *
+ * 求和是精确的整数加法，结果与累加顺序无关，并行或分块汇总也能得到相同的结果。
+ */
+class Money {
+private:
+    int64_t cents;
+
+    explicit Money(int64_t cents) : cents(cents) {}
+
+public:
+    Money() : cents(0) {}
+
+    static Money fromCents(int64_t cents) { return Money(cents); }
+    // 四舍五入到分
+    static Money fromYuan(double yuan);
+
+    int64_t getCents() const { return cents; }
+    double toYuan() const { return static_cast<double>(cents) / 100.0; }
+
+    // 解析金额文本（支持千分位逗号，超过两位的小数四舍五入到分），不抛异常
+    static ParseStatus parse(const char* data, size_t size, Money& out);
+    static ParseStatus parse(const std::string& text, Money& out);
+
+    // 两位小数的文本，如 1234.50、-0.05（不带货币符号和千分位）
+    std::string toString() const;
+    void appendTo(std::string& out) const;
+
+    bool isZero() const { return cents == 0; }
+    bool isPositive() const { return cents > 0; }
+
+    Money& operator+=(Money other) { cents += other.cents; return *this; }
+    Money& operator-=(Money other) { cents -= other.cents; return *this; }
+    Money operator+(Money other) const { return Money(cents + other.cents); }
+    Money operator-(Money other) const { return Money(cents - other.cents); }
+    Money operator-() const { return Money(-cents); }
+
+    bool operator==(Money other) const { return cents == other.cents; }
+    bool operator!=(Money other) const { return cents != other.cents; }
+    bool operator<(Money other) const { return cents < other.cents; }
+    bool operator<=(Money other) const { return cents <= other.cents; }
+    bool operator>(Money other) const { return cents > other.cents; }
+    bool operator>=(Money other) const { return cents >= other.cents; }
+};
+
+#endif // MONEY_H
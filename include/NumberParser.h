@@ -0,0 +1,36 @@
+#ifndef NUMBER_PARSER_H
+#define NUMBER_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 解析结果状态码
+ */
+enum class ParseStatus : unsigned char {
+    Ok,
+    Empty,          // 字段为空
+    InvalidNumber,  // 含有非数字字符
+    BadGrouping,    // 千分位分组不正确，如 1,00.00
+    OutOfRange,     // 超出可表示的范围
+    InvalidDate,    // 不是 1900~2100 年间有效的 YYYY-MM-DD 日期
+    MissingFields,  // 记录字段数不足
+    TooManyStrings  // 不同的分类或对象过多，超出字典容量
+};
+
+/**
+ * @brief 不抛异常的数值解析，用于加载ID和金额
+ *
+ * 整个字段（允许首尾空格）必须是一个数；整数部分可以带千分位逗号（8,000.00）。
+ */
+class NumberParser {
+public:
+    static ParseStatus parseInt(const char* data, size_t size, int& out);
+    // 金额按分解析：两位以内的小数是精确的，更多位的小数四舍五入到分
+    static ParseStatus parseCents(const char* data, size_t size, int64_t& out);
+
+    // 状态码的中文说明
+    static const char* describe(ParseStatus status);
+};
+
+#endif // NUMBER_PARSER_H
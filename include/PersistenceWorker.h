@@ -0,0 +1,66 @@
+#ifndef PERSISTENCE_WORKER_H
+#define PERSISTENCE_WORKER_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+/**
+ * @brief 后台持久化线程：在界面线程之外批量写入日志（group commit）
+ *
+ * append 只把条目放入队列后立即返回；后台线程收到第一条后再等待一个持久化窗口，
+ * 把窗口内到达的全部条目按文件合并为一次写入并刷盘。
+ * 写入失败（如磁盘暂时不可用）时，未写入的部分放回队首，在下一个窗口重试，成功后恢复正常；
+ * 失败只通过 flush() 的返回值报告，不影响后续 append。
+ * 窗口为0时不启动线程，每次 append 都同步写入并刷盘。
+ */
+class PersistenceWorker {
+private:
+    struct PendingFile {
+        std::string path;
+        std::string buffer;
+        uint64_t entries;   // buffer 中的条目数
+        PendingFile() : entries(0) {}
+    };
+
+    unsigned windowMs;
+    std::mutex mutex;
+    std::condition_variable wake;       // 通知后台线程有新条目或需要立即落盘
+    std::condition_variable persisted;  // 通知等待者一批条目已落盘
+    std::vector<PendingFile> pending;
+    uint64_t enqueuedCount;
+    uint64_t persistedCount;    // 已落盘的条目数
+    uint64_t attemptCount;      // 已完成的批量写入次数（含失败的）
+    bool flushRequested;
+    bool stopping;
+    bool failed;                // 最近一次批量写入是否失败
+    std::thread worker;
+
+    void run();
+    // 写入一批条目，返回需要重试的部分（只含未写入的剩余内容），writtenEntries 累加已落盘的条目数
+    static std::vector<PendingFile> writeBatch(const std::vector<PendingFile>& batch, uint64_t& writtenEntries);
+    // 把写入失败的部分放回队首，排在之后到达的同一文件的条目前面
+    void requeue(std::vector<PendingFile>& unwritten);
+
+public:
+    explicit PersistenceWorker(unsigned windowMs);
+    ~PersistenceWorker();
+
+    // 禁止拷贝
+    PersistenceWorker(const PersistenceWorker&) = delete;
+    PersistenceWorker& operator=(const PersistenceWorker&) = delete;
+
+    // 追加一条日志条目；异步模式下总是成功入队，同步模式下返回写入结果
+    bool append(const std::string& path, const std::string& entry);
+
+    // 立即写入队列中的全部条目并等待刷盘完成，返回是否全部落盘；
+    // 写入失败时不再等待，返回false，未写入的条目留在队列中继续重试
+    bool flush();
+
+    unsigned getWindowMs() const;
+};
+
+#endif // PERSISTENCE_WORKER_H
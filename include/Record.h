@@ -3,6 +3,9 @@
 
 #include <string>
 #include <iostream>
+#include "Money.h"
+#include "Date.h"
+#include "StringDictionary.h"
 
 /**
  * @brief 记录基类，定义收入和支出记录的公共属性和接口
@@ -10,30 +13,32 @@
 class Record {
 protected:
     int id;                     // 记录唯一标识
-    std::string date;           // 日期，格式: YYYY-MM-DD
-    double amount;              // 金额
-    std::string category;       // 分类
+    Date date;                  // 日期（打包的 yyyymmdd）
+    Money amount;               // 金额（以分为单位的定点数）
+    uint32_t category;          // 分类在 StringDictionary::categories() 中的 ID
     std::string description;    // 描述
 
 public:
     // 构造函数
     Record();
-    Record(int id, const std::string& date, double amount,
+    Record(int id, Date date, Money amount,
            const std::string& category, const std::string& description);
     virtual ~Record() = default;
 
     // Getters
     int getId() const;
-    std::string getDate() const;
-    double getAmount() const;
-    std::string getCategory() const;
+    Date getDate() const;
+    Money getAmount() const;
+    const std::string& getCategory() const;
+    uint32_t getCategoryId() const;
     std::string getDescription() const;
 
     // Setters
     void setId(int id);
-    void setDate(const std::string& date);
-    void setAmount(double amount);
+    void setDate(Date date);
+    void setAmount(Money amount);
     void setCategory(const std::string& category);
+    void setCategoryId(uint32_t categoryId);
     void setDescription(const std::string& description);
 
     // 纯虚函数 - 子类必须实现
@@ -0,0 +1,180 @@
+#ifndef RECORD_COLUMNS_H
+#define RECORD_COLUMNS_H
+
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "IncomeRecord.h"
+#include "ExpenseRecord.h"
+#include "SimdKernels.h"
+
+/**
+ * @brief 按列存放的记录表（列式存储）
+ *
+ * ID、日期、金额、分类、对象各占一个连续数组，描述文本追加在一个共享的字符串堆中。
+ * 只读某一列的统计（求和、按月/按分类汇总）顺序扫描对应数组即可，不必把整条记录读入缓存。
+ * 需要记录对象时用 get() 按槽位组装，记录对象只是列数据的一个视图。
+ *
+ * T 为 IncomeRecord 或 ExpenseRecord，"对象"列分别对应收入来源和支付对象。
+ */
+template <typename T>
+class RecordColumns {
+private:
+    std::vector<int> ids;
+    std::vector<uint32_t> dates;        // 打包日期 yyyymmdd
+    std::vector<int64_t> amounts;       // 金额（分）
+    std::vector<uint32_t> categories;   // StringDictionary::categories() 中的 ID
+    std::vector<uint32_t> parties;      // StringDictionary::parties() 中的 ID
+    std::vector<uint32_t> descOffsets;  // 描述在 descHeap 中的起点和长度
+    std::vector<uint32_t> descLengths;
+    std::string descHeap;
+    size_t deadBytes;                   // 修改或删除后 descHeap 中不再被引用的字节数
+
+    static uint32_t partyIdOf(const IncomeRecord& record) { return record.getSourceId(); }
+    static uint32_t partyIdOf(const ExpenseRecord& record) { return record.getPayeeId(); }
+    static void setPartyId(IncomeRecord& record, uint32_t id) { record.setSourceId(id); }
+    static void setPartyId(ExpenseRecord& record, uint32_t id) { record.setPayeeId(id); }
+
+    void storeDescription(size_t slot, const std::string& text) {
+        descOffsets[slot] = static_cast<uint32_t>(descHeap.size());
+        descLengths[slot] = static_cast<uint32_t>(text.size());
+        descHeap += text;
+    }
+
+    // 废弃的文本超过堆的一半时按当前槽位顺序重写一遍
+    void compactHeapIfNeeded() {
+        if (deadBytes < 4096 || deadBytes * 2 < descHeap.size()) return;
+        std::string heap;
+        heap.reserve(descHeap.size() - deadBytes);
+        for (size_t i = 0; i < ids.size(); ++i) {
+            uint32_t offset = static_cast<uint32_t>(heap.size());
+            heap.append(descHeap, descOffsets[i], descLengths[i]);
+            descOffsets[i] = offset;
+        }
+        descHeap.swap(heap);
+        deadBytes = 0;
+    }
+
+public:
+    RecordColumns() : deadBytes(0) {}
+
+    size_t size() const { return ids.size(); }
+    bool empty() const { return ids.empty(); }
+
+    void clear() {
+        ids.clear(); dates.clear(); amounts.clear(); categories.clear(); parties.clear();
+        descOffsets.clear(); descLengths.clear(); descHeap.clear();
+        deadBytes = 0;
+    }
+
+    // 用一批记录替换全部内容
+    void assign(const std::vector<T>& records) {
+        clear();
+        size_t bytes = 0;
+        for (const auto& r : records) bytes += r.getDescription().size();
+        ids.reserve(records.size()); dates.reserve(records.size()); amounts.reserve(records.size());
+        categories.reserve(records.size()); parties.reserve(records.size());
+        descOffsets.reserve(records.size()); descLengths.reserve(records.size());
+        descHeap.reserve(bytes);
+        for (const auto& r : records) append(r);
+    }
+
+    // 追加一条记录，返回其槽位
+    size_t append(const T& record) {
+        size_t slot = ids.size();
+        ids.push_back(record.getId());
+        dates.push_back(record.getDate().getPacked());
+        amounts.push_back(record.getAmount().getCents());
+        categories.push_back(record.getCategoryId());
+        parties.push_back(partyIdOf(record));
+        descOffsets.push_back(0);
+        descLengths.push_back(0);
+        storeDescription(slot, record.getDescription());
+        return slot;
+    }
+
+    // 覆盖某个槽位；描述不变时不动字符串堆
+    void set(size_t slot, const T& record) {
+        ids[slot] = record.getId();
+        dates[slot] = record.getDate().getPacked();
+        amounts[slot] = record.getAmount().getCents();
+        categories[slot] = record.getCategoryId();
+        parties[slot] = partyIdOf(record);
+        const std::string& text = record.getDescription();
+        if (text.size() != descLengths[slot] || descHeap.compare(descOffsets[slot], descLengths[slot], text) != 0) {
+            deadBytes += descLengths[slot];
+            storeDescription(slot, text);
+            compactHeapIfNeeded();
+        }
+    }
+
+    // 删除某个槽位：把最后一个槽位移到这里再弹出，其他槽位不动。
+    // 返回被移动记录原来的槽位（即删除前的 size()-1），删除的就是最后一个时返回 slot 本身
+    size_t swapRemove(size_t slot) {
+        size_t last = ids.size() - 1;
+        deadBytes += descLengths[slot];
+        if (slot != last) {
+            ids[slot] = ids[last];
+            dates[slot] = dates[last];
+            amounts[slot] = amounts[last];
+            categories[slot] = categories[last];
+            parties[slot] = parties[last];
+            descOffsets[slot] = descOffsets[last];
+            descLengths[slot] = descLengths[last];
+        }
+        ids.pop_back(); dates.pop_back(); amounts.pop_back(); categories.pop_back(); parties.pop_back();
+        descOffsets.pop_back(); descLengths.pop_back();
+        compactHeapIfNeeded();
+        return last;
+    }
+
+    // 在某个槽位上组装记录对象
+    T get(size_t slot) const {
+        T record;
+        record.setId(ids[slot]);
+        record.setDate(Date::fromPacked(dates[slot]));
+        record.setAmount(Money::fromCents(amounts[slot]));
+        record.setCategoryId(categories[slot]);
+        setPartyId(record, parties[slot]);
+        record.setDescription(descHeap.substr(descOffsets[slot], descLengths[slot]));
+        return record;
+    }
+
+    // 按槽位顺序组装全部记录（交给存储层写文件时使用）
+    std::vector<T> toRecords() const {
+        std::vector<T> records;
+        records.reserve(size());
+        for (size_t i = 0; i < size(); ++i) records.push_back(get(i));
+        return records;
+    }
+
+    // 各列的只读访问，供统计时顺序扫描
+    const std::vector<int>& idColumn() const { return ids; }
+    const std::vector<uint32_t>& dateColumn() const { return dates; }
+    const std::vector<int64_t>& amountColumn() const { return amounts; }
+    const std::vector<uint32_t>& categoryColumn() const { return categories; }
+    const std::vector<uint32_t>& partyColumn() const { return parties; }
+
+    int idAt(size_t slot) const { return ids[slot]; }
+    Date dateAt(size_t slot) const { return Date::fromPacked(dates[slot]); }
+    Money amountAt(size_t slot) const { return Money::fromCents(amounts[slot]); }
+    uint32_t categoryAt(size_t slot) const { return categories[slot]; }
+    uint32_t partyAt(size_t slot) const { return parties[slot]; }
+    std::string descriptionAt(size_t slot) const { return descHeap.substr(descOffsets[slot], descLengths[slot]); }
+    void appendDescriptionTo(size_t slot, std::string& out) const { out.append(descHeap, descOffsets[slot], descLengths[slot]); }
+    // 描述中是否含有 text，直接在字符串堆上比较，不复制描述
+    bool descriptionContains(size_t slot, const std::string& text) const {
+        const char* begin = descHeap.data() + descOffsets[slot];
+        const char* end = begin + descLengths[slot];
+        return std::search(begin, end, text.begin(), text.end()) != end;
+    }
+
+    // 全部金额之和，向量化顺序扫描金额列
+    Money totalAmount() const {
+        return Money::fromCents(SimdKernels::sum(amounts.data(), amounts.size()));
+    }
+};
+
+#endif // RECORD_COLUMNS_H
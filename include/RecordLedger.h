@@ -0,0 +1,212 @@
+#ifndef RECORD_LEDGER_H
+#define RECORD_LEDGER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "RecordColumns.h"
+#include "IdIndex.h"
+#include "DateIndex.h"
+#include "TextIndex.h"
+#include "LedgerTotals.h"
+#include "StringDictionary.h"
+#include <algorithm>
+
+/**
+ * @brief 一类记录（收入或支出）的内存数据：列式存储加上随增删改同步维护的索引
+ *
+ * 所有修改都经过这里，保证列数据与各个索引始终一致。
+ */
+template <typename T>
+class RecordLedger {
+private:
+    RecordColumns<T> columns;
+    IdIndex ids;        // ID -> 槽位
+    DateIndex byDate;   // 按 (日期, ID) 排序的槽位
+    // 每个分类一份按日期排序的倒排表，下标为分类 ID；分类查询只访问命中的记录
+    std::vector<DateIndex> byCategory;
+    TextIndex byText;   // 描述和收入来源/支付对象的全文索引，按记录ID组织
+    LedgerTotals totals;
+
+    void appendToTotals(size_t slot) {
+        totals.append(columns.dateColumn()[slot], columns.categoryAt(slot), columns.amountColumn()[slot]);
+    }
+    void addToTotals(size_t slot) {
+        totals.add(columns.dateColumn()[slot], columns.categoryAt(slot), columns.amountColumn()[slot]);
+    }
+    void removeFromTotals(size_t slot) {
+        totals.remove(columns.dateColumn()[slot], columns.categoryAt(slot), columns.amountColumn()[slot]);
+    }
+
+    // 参与全文检索的文本：描述和对象之间用换行隔开，关键词不会跨字段匹配
+    std::string searchText(size_t slot) const {
+        std::string text;
+        appendSearchText(slot, text);
+        return text;
+    }
+
+    void appendSearchText(size_t slot, std::string& out) const {
+        columns.appendDescriptionTo(slot, out);
+        out += '\n';
+        out += StringDictionary::parties().text(columns.partyAt(slot));
+    }
+
+    bool containsText(size_t slot, const std::string& keyword) const {
+        if (columns.descriptionContains(slot, keyword)) return true;
+        return StringDictionary::parties().text(columns.partyAt(slot)).find(keyword) != std::string::npos;
+    }
+
+    DateIndex::Entry dateEntry(size_t slot) const {
+        DateIndex::Entry entry = {columns.dateColumn()[slot], columns.idAt(slot), static_cast<uint32_t>(slot)};
+        return entry;
+    }
+
+    DateIndex& categoryIndex(uint32_t categoryId) {
+        if (categoryId >= byCategory.size()) byCategory.resize(categoryId + 1);
+        return byCategory[categoryId];
+    }
+
+public:
+    // 用加载得到的记录替换全部内容并重建索引
+    void assign(const std::vector<T>& records) {
+        columns.assign(records);
+        ids.clear();
+        ids.reserve(columns.size());
+        std::vector<DateIndex::Entry> entries;
+        std::vector<std::vector<DateIndex::Entry>> categoryEntries;
+        byText.clear();
+        totals.clear();
+        entries.reserve(columns.size());
+        for (size_t i = 0; i < columns.size(); ++i) {
+            ids.set(columns.idAt(i), static_cast<uint32_t>(i));
+            appendToTotals(i);
+            entries.push_back(dateEntry(i));
+            uint32_t categoryId = columns.categoryAt(i);
+            if (categoryId >= categoryEntries.size()) categoryEntries.resize(categoryId + 1);
+            categoryEntries[categoryId].push_back(entries.back());
+        }
+        // 按ID顺序追加，倒排表天然有序，finish() 不必再逐表排序
+        std::vector<uint32_t> slotsById(columns.size());
+        for (size_t i = 0; i < slotsById.size(); ++i) slotsById[i] = static_cast<uint32_t>(i);
+        const std::vector<int>& recordIds = columns.idColumn();
+        std::sort(slotsById.begin(), slotsById.end(), [&recordIds](uint32_t a, uint32_t b) { return recordIds[a] < recordIds[b]; });
+        std::string text;
+        for (uint32_t slot : slotsById) {
+            text.clear();
+            appendSearchText(slot, text);
+            byText.append(recordIds[slot], text);
+        }
+        byText.finish();
+        totals.finish();
+        byDate.build(std::move(entries));
+        byCategory.clear();
+        byCategory.resize(categoryEntries.size());
+        for (size_t c = 0; c < categoryEntries.size(); ++c) byCategory[c].build(std::move(categoryEntries[c]));
+    }
+
+    void add(const T& record) {
+        size_t slot = columns.append(record);
+        ids.set(record.getId(), static_cast<uint32_t>(slot));
+        byDate.insert(dateEntry(slot));
+        categoryIndex(record.getCategoryId()).insert(dateEntry(slot));
+        byText.add(record.getId(), searchText(slot));
+        addToTotals(slot);
+    }
+
+    bool findSlot(int id, size_t& slot) const {
+        uint32_t found;
+        if (!ids.find(id, found)) return false;
+        slot = found;
+        return true;
+    }
+
+    bool get(int id, T& record) const {
+        size_t slot;
+        if (!findSlot(id, slot)) return false;
+        record = columns.get(slot);
+        return true;
+    }
+
+    // 删除：最后一条记录移入空出的槽位，同步更新它在各索引中的位置
+    bool remove(int id, T& removed) {
+        size_t slot;
+        if (!findSlot(id, slot)) return false;
+        removed = columns.get(slot);
+        byDate.erase(columns.dateColumn()[slot], id);
+        byCategory[columns.categoryAt(slot)].erase(columns.dateColumn()[slot], id);
+        byText.remove(id, searchText(slot));
+        removeFromTotals(slot);
+        ids.erase(id);
+        size_t moved = columns.swapRemove(slot);
+        if (moved != slot) {
+            uint32_t date = columns.dateColumn()[slot];
+            int movedId = columns.idAt(slot);
+            ids.set(movedId, static_cast<uint32_t>(slot));
+            byDate.moveSlot(date, movedId, static_cast<uint32_t>(slot));
+            byCategory[columns.categoryAt(slot)].moveSlot(date, movedId, static_cast<uint32_t>(slot));
+        }
+        return true;
+    }
+
+    // 覆盖某个槽位上的记录（ID 不变），日期、分类或文本变化时调整它在索引中的位置
+    void update(size_t slot, const T& record) {
+        uint32_t oldDate = columns.dateColumn()[slot];
+        uint32_t oldCategory = columns.categoryAt(slot);
+        std::string oldText = searchText(slot);
+        removeFromTotals(slot);
+        columns.set(slot, record);
+        addToTotals(slot);
+        std::string newText = searchText(slot);
+        if (newText != oldText) {
+            byText.remove(columns.idAt(slot), oldText);
+            byText.add(columns.idAt(slot), newText);
+        }
+        uint32_t newDate = columns.dateColumn()[slot];
+        uint32_t newCategory = columns.categoryAt(slot);
+        if (newDate != oldDate) {
+            byDate.erase(oldDate, columns.idAt(slot));
+            byDate.insert(dateEntry(slot));
+        }
+        if (newDate != oldDate || newCategory != oldCategory) {
+            byCategory[oldCategory].erase(oldDate, columns.idAt(slot));
+            categoryIndex(newCategory).insert(dateEntry(slot));
+        }
+    }
+
+    size_t size() const { return columns.size(); }
+    const RecordColumns<T>& getColumns() const { return columns; }
+    const DateIndex& getDateIndex() const { return byDate; }
+    const LedgerTotals& getTotals() const { return totals; }
+    /**
+     * 描述或对象中含有关键词的记录槽位，按 (日期, ID) 排序。
+     * 先用全文索引取候选再逐条核对原文；关键词只有一个字符时索引帮不上忙，改为逐条核对全部记录。
+     */
+    std::vector<uint32_t> search(const std::string& keyword) const {
+        std::vector<uint32_t> slots;
+        if (keyword.empty()) return slots;
+        std::vector<int> candidates;
+        if (byText.candidates(keyword, candidates)) {
+            for (int id : candidates) {
+                size_t slot;
+                if (findSlot(id, slot) && containsText(slot, keyword)) slots.push_back(static_cast<uint32_t>(slot));
+            }
+        } else {
+            for (size_t slot = 0; slot < columns.size(); ++slot) {
+                if (containsText(slot, keyword)) slots.push_back(static_cast<uint32_t>(slot));
+            }
+        }
+        const std::vector<uint32_t>& dates = columns.dateColumn();
+        const std::vector<int>& recordIds = columns.idColumn();
+        std::sort(slots.begin(), slots.end(), [&dates, &recordIds](uint32_t a, uint32_t b) {
+            return dates[a] != dates[b] ? dates[a] < dates[b] : recordIds[a] < recordIds[b];
+        });
+        return slots;
+    }
+
+    // 某个分类按日期排序的倒排表，该分类从未出现过时返回 nullptr
+    const DateIndex* getCategoryIndex(uint32_t categoryId) const {
+        return categoryId < byCategory.size() ? &byCategory[categoryId] : nullptr;
+    }
+};
+
+#endif // RECORD_LEDGER_H
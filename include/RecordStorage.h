@@ -3,45 +3,177 @@
 
 #include <string>
 #include <vector>
+#include <fstream>
+#include <thread>
 #include "IncomeRecord.h"
 #include "ExpenseRecord.h"
+#include "RecordColumns.h"
+#include "LedgerSnapshot.h"
+#include "PersistenceWorker.h"
+
+/**
+ * @brief 日志操作类型：新增/修改统一记为 Upsert，删除记为 Delete（两者都带完整记录，便于定位所在月份）
+ */
+enum class JournalOp : char {
+    Upsert = 'U',
+    Delete = 'D'
+};
+
+/**
+ * @brief 基础数据文件的布局
+ */
+enum class StorageLayout {
+    SingleFile,         // 每类记录一个CSV文件，如 data/expense.csv
+    MonthPartitioned    // 每月一个CSV文件，如 data/expense/2024-01.csv
+};
+
+/**
+ * @brief 存储选项
+ */
+struct StorageOptions {
+    // 加载线程数：0 表示按CPU核数自动选择，1 表示单线程顺序加载
+    unsigned loadThreads = 0;
+    // 基础文件布局
+    StorageLayout layout = StorageLayout::SingleFile;
+    // 持久化窗口（毫秒）：修改在该时间内由后台线程批量写入日志并刷盘；0 表示每次修改同步落盘
+    unsigned durabilityWindowMs = 100;
+};
+
+/**
+ * @brief 加载时因格式错误被跳过的一行
+ */
+struct LoadIssue {
+    std::string file;
+    size_t line;            // 行号，从1开始
+    size_t column;          // 出错的列，从1开始
+    ParseStatus status;
+
+    LoadIssue() : line(0), column(0), status(ParseStatus::Ok) {}
+};
+
+/**
+ * @brief 一张表的加载报告
+ */
+struct LoadReport {
+    std::vector<LoadIssue> issues;  // 最多保留 MAX_REPORTED_ISSUES 条明细
+    size_t skippedRows = 0;
+};
 
 /**
  * @brief 数据存储类，负责文件读写和数据持久化
+ *
+ * 单条记录的增删改以追加方式写入数据文件旁的日志（如 data/income.csv.journal），
+ * 日志由后台持久化线程按持久化窗口批量提交，
+ * 启动加载时在基础CSV之上重放日志；日志超过阈值后在后台线程压缩回基础文件。
+ * 每次写回基础文件时同时生成二进制快照 ledger.ffm，供下次启动直接批量读取。
+ * 基础文件和快照都先写临时文件、刷盘后再原子改名，进程中途被杀不会损坏已有数据。
+ *
+ * 按月分区布局下，压缩只重写日志中涉及到的月份文件，其余月份保持只读；
+ * 从单文件迁移完成后分区目录中留有标记，此后该表始终按分区加载。
  */
 class RecordStorage {
 private:
     std::string incomeFilePath;
     std::string expenseFilePath;
+    std::string snapshotFilePath;
+    StorageOptions options;
     int nextIncomeId;
     int nextExpenseId;
 
-    // CSV处理辅助函数
-    std::string escapeCSV(const std::string& field) const;
-    std::string unescapeCSV(const std::string& field) const;
-    std::vector<std::string> splitCSV(const std::string& line) const;
-    
+    // 追加日志（后台批量提交；查询和压缩前先刷盘）
+    mutable PersistenceWorker journalWriter;
+    long incomeJournalBytes;
+    long expenseJournalBytes;
+    std::thread compactionThread;
+
+    // 最近一次从CSV加载时跳过的行（收入和支出可能并行加载，分开记录）
+    LoadReport incomeReport;
+    LoadReport expenseReport;
+
     // 确保数据目录存在
     bool ensureDataDirectory() const;
 
+    // 日志辅助函数
+    bool appendJournal(const std::string& path, long& bytes, JournalOp op, const std::string& csv);
+
+    // 写回基础文件；按月分区时只重写日志（journalPaths）中涉及的月份
+    bool writeIncomeBase(const std::vector<IncomeRecord>& records,
+                         const std::vector<std::string>& journalPaths) const;
+    bool writeExpenseBase(const std::vector<ExpenseRecord>& records,
+                          const std::vector<std::string>& journalPaths) const;
+
+    // 基础文件的变更标记，按月分区时汇总分区目录内的全部文件
+    FileStamp incomeStamp() const;
+    FileStamp expenseStamp() const;
+
+    // 基础数据就绪后重放日志并更新下一个ID
+    void finishIncomeLoad(std::vector<IncomeRecord>& records);
+    void finishExpenseLoad(std::vector<ExpenseRecord>& records);
+
 public:
+    // 日志累计超过该字节数后触发后台压缩
+    static const long JOURNAL_COMPACT_THRESHOLD = 1024 * 1024;
+    // 并行加载时每块的最小字节数，小文件直接单线程解析
+    static const size_t PARALLEL_CHUNK_BYTES = 1024 * 1024;
+    // 每张表最多保留的错误行明细
+    static const size_t MAX_REPORTED_ISSUES = 100;
+
     // 构造函数
     RecordStorage(const std::string& incomeFile = "data/income.csv",
-                  const std::string& expenseFile = "data/expense.csv");
+                  const std::string& expenseFile = "data/expense.csv",
+                  const StorageOptions& options = StorageOptions());
+    ~RecordStorage();
+
+    // 实际使用的加载线程数
+    unsigned getLoadThreads() const;
 
-    // 收入记录操作
+    // 收入记录操作（加载时会重放日志）
     std::vector<IncomeRecord> loadIncomeRecords();
     bool saveIncomeRecords(const std::vector<IncomeRecord>& records);
+    bool appendIncomeJournal(JournalOp op, const IncomeRecord& record);
     int getNextIncomeId();
 
-    // 支出记录操作
+    // 支出记录操作（加载时会重放日志）
     std::vector<ExpenseRecord> loadExpenseRecords();
     bool saveExpenseRecords(const std::vector<ExpenseRecord>& records);
+    bool appendExpenseJournal(JournalOp op, const ExpenseRecord& record);
     int getNextExpenseId();
-    
+
+    // 最近一次从CSV加载时因格式错误跳过的行
+    std::vector<LoadIssue> getLoadIssues() const;
+    size_t getSkippedRowCount() const;
+
+    // 二进制快照（启动快速路径），与CSV基础文件不一致时自动失效
+    bool loadSnapshot(std::vector<IncomeRecord>& income, std::vector<ExpenseRecord>& expense);
+    bool saveSnapshot(const std::vector<IncomeRecord>& income,
+                      const std::vector<ExpenseRecord>& expense) const;
+
+    // 等待队列中的日志条目全部写入并刷盘
+    bool flushJournals();
+
+    // 启动时清理上次中断留下的临时文件并截掉日志末尾不完整的条目，返回是否做过修复
+    bool recoverInterruptedWrites();
+
+    // 日志压缩
+    bool needsCompaction() const;
+    bool hasPendingCompaction() const;
+    // 传入列式数据的副本（几次连续数组拷贝），由后台线程组装记录并写文件
+    void compactInBackground(RecordColumns<IncomeRecord> income,
+                             RecordColumns<ExpenseRecord> expense);
+    void waitForCompaction();
+    bool checkpoint(const std::vector<IncomeRecord>& income,
+                    const std::vector<ExpenseRecord>& expense);
+
     // 文件路径
     std::string getIncomeFilePath() const;
     std::string getExpenseFilePath() const;
+    std::string getIncomeJournalPath() const;
+    std::string getExpenseJournalPath() const;
+    std::string getSnapshotFilePath() const;
+    // 按月分区目录，如 data/expense
+    std::string getIncomePartitionDir() const;
+    std::string getExpensePartitionDir() const;
+    StorageLayout getLayout() const;
 };
 
 #endif // RECORD_STORAGE_H
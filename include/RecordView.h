@@ -0,0 +1,270 @@
+#ifndef RECORD_VIEW_H
+#define RECORD_VIEW_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include "RecordColumns.h"
+#include "DateIndex.h"
+#include "StringDictionary.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief 列式存储中某一条记录的只读引用
+ *
+ * 只保存列存储指针和槽位，各字段按需从列中读取；分类和对象文本直接返回字典中的引用，不复制字符串。
+ * 需要独立的记录对象时调用 toRecord()。
+ */
+template <typename T>
+class RecordRef {
+public:
+    RecordRef(const RecordColumns<T>* columns, uint32_t slot) : columns(columns), slot(slot) {}
+
+    uint32_t getSlot() const { return slot; }
+    int getId() const { return columns->idAt(slot); }
+    Date getDate() const { return columns->dateAt(slot); }
+    Money getAmount() const { return columns->amountAt(slot); }
+    uint32_t getCategoryId() const { return columns->categoryAt(slot); }
+    const std::string& getCategory() const { return StringDictionary::categories().text(getCategoryId()); }
+    // 收入来源或支付对象
+    uint32_t getPartyId() const { return columns->partyAt(slot); }
+    const std::string& getParty() const { return StringDictionary::parties().text(getPartyId()); }
+    std::string getDescription() const { return columns->descriptionAt(slot); }
+
+    T toRecord() const { return columns->get(slot); }
+
+private:
+    const RecordColumns<T>* columns;
+    uint32_t slot;
+};
+
+/**
+ * @brief 查询结果视图：逐条给出 RecordRef，查询得到的视图按 (日期, ID) 排序
+ *
+ * 日期范围和分类查询的视图只是索引上的一对位置，不分配内存；遍历时才按槽位读取字段。
+ * 关键词搜索和前K条的结果是一份槽位列表（每条4字节，不复制记录），分页只调整列表上的区间。
+ * 视图引用的是存储本身，对应的收入或支出被增删改后视图即失效，需要重新查询。
+ */
+template <typename T>
+class RecordView {
+public:
+    // 整日区间至少占全部记录的几分之一时，改为按日期过滤顺序扫描整列
+    static const size_t COLUMN_SCAN_SHARE = 4;
+
+    class Iterator {
+    public:
+        RecordRef<T> operator*() const {
+            return RecordRef<T>(columns, slots ? *slot : position->slot);
+        }
+        Iterator& operator++() {
+            if (slots) ++slot; else ++position;
+            return *this;
+        }
+        bool operator==(const Iterator& other) const { return slots ? slot == other.slot : position == other.position; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class RecordView;
+        Iterator(const RecordColumns<T>* columns, DateIndex::Iterator position)
+            : columns(columns), position(position), slots(false), slot(nullptr) {}
+        Iterator(const RecordColumns<T>* columns, const uint32_t* slot)
+            : columns(columns), slots(true), slot(slot) {}
+        const RecordColumns<T>* columns;
+        DateIndex::Iterator position;
+        bool slots;
+        const uint32_t* slot;
+    };
+
+    // 空视图
+    RecordView() : columns(nullptr), index(nullptr), slotBegin(0), slotEnd(0) {}
+    // 日期索引上的一段 [first, last)
+    RecordView(const RecordColumns<T>& columns, const DateIndex& index, DateIndex::Iterator first, DateIndex::Iterator last)
+        : columns(&columns), index(&index), first(first), last(last), slotBegin(0), slotEnd(0) {}
+    // 一份槽位列表，视图按列表顺序遍历
+    RecordView(const RecordColumns<T>& columns, std::vector<uint32_t> slots)
+        : columns(&columns), index(nullptr), slots(std::make_shared<const std::vector<uint32_t>>(std::move(slots))),
+          slotBegin(0), slotEnd(this->slots->size()) {}
+
+    Iterator begin() const {
+        if (slots) return Iterator(columns, slots->data() + slotBegin);
+        return Iterator(columns, first);
+    }
+    Iterator end() const {
+        if (slots) return Iterator(columns, slots->data() + slotEnd);
+        return Iterator(columns, last);
+    }
+
+    bool empty() const { return slots ? slotBegin == slotEnd : first == last; }
+    size_t size() const {
+        if (slots) return slotEnd - slotBegin;
+        return index ? index->distance(first, last) : 0;
+    }
+
+    // 跳过前 offset 条后最多 limit 条；耗时与跳过的块数和 limit 有关，与视图总条数无关
+    RecordView page(size_t offset, size_t limit) const {
+        RecordView result(*this);
+        if (slots) {
+            result.slotBegin = slotBegin + std::min(offset, slotEnd - slotBegin);
+            result.slotEnd = result.slotBegin + std::min(limit, slotEnd - result.slotBegin);
+        } else if (index) {
+            result.first = index->advance(first, offset, last);
+            result.last = index->advance(result.first, limit, last);
+        }
+        return result;
+    }
+
+    // 最后 k 条，按从新到旧的顺序；从末尾倒着走，只访问这 k 条
+    RecordView latest(size_t k) const {
+        std::vector<uint32_t> picked;
+        if (slots) {
+            for (size_t i = slotEnd; i > slotBegin && picked.size() < k; --i) picked.push_back((*slots)[i - 1]);
+        } else if (index) {
+            for (DateIndex::Iterator it = last; it != first && picked.size() < k;) {
+                --it;
+                picked.push_back(it->slot);
+            }
+        }
+        return columns ? RecordView(*columns, std::move(picked)) : RecordView();
+    }
+
+    /**
+     * 金额最大的 k 条，按金额从大到小；金额相同时日期早的在前，再按 ID。
+     * 用容量为 k 的小顶堆扫描一遍视图，只有进入前 k 的记录才需要调整堆，最后只对这 k 条排序。
+     * 视图覆盖全部记录时直接顺序扫描金额列，不沿索引跳着读。
+     */
+    RecordView topByAmount(size_t k) const {
+        if (!columns || k == 0) return RecordView();
+        struct Candidate {
+            int64_t amount;
+            uint32_t date;
+            int id;
+            uint32_t slot;
+        };
+        // better(a, b)：a 排在 b 前面；以它作比较器时堆顶是当前入选者中最差的一条
+        auto better = [](const Candidate& a, const Candidate& b) {
+            if (a.amount != b.amount) return a.amount > b.amount;
+            return a.date != b.date ? a.date < b.date : a.id < b.id;
+        };
+        const std::vector<int64_t>& amounts = columns->amountColumn();
+        const std::vector<uint32_t>& dates = columns->dateColumn();
+        const std::vector<int>& ids = columns->idColumn();
+        std::vector<Candidate> heap;
+        heap.reserve(std::min(k, size()));
+        auto consider = [&](uint32_t slot) {
+            // 堆满后先只比金额，绝大多数记录在这里就被排除
+            if (heap.size() == k && amounts[slot] < heap.front().amount) return;
+            Candidate candidate = {amounts[slot], dates[slot], ids[slot], slot};
+            if (heap.size() < k) {
+                heap.push_back(candidate);
+                std::push_heap(heap.begin(), heap.end(), better);
+            } else if (better(candidate, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), better);
+                heap.back() = candidate;
+                std::push_heap(heap.begin(), heap.end(), better);
+            }
+        };
+        if (!slots && index && index->size() == columns->size() && first == index->begin() && last == index->end()) {
+            // 堆满后用向量化查找直接跳到下一条金额不小于堆顶的记录
+            size_t count = columns->size();
+            for (size_t slot = 0; slot < count; ++slot) {
+                if (heap.size() == k) {
+                    slot += SimdKernels::findAtLeast(amounts.data() + slot, count - slot, heap.front().amount);
+                    if (slot == count) break;
+                }
+                consider(static_cast<uint32_t>(slot));
+            }
+        } else {
+            for (const RecordRef<T>& ref : *this) consider(ref.getSlot());
+        }
+        std::sort_heap(heap.begin(), heap.end(), better);
+        std::vector<uint32_t> picked;
+        picked.reserve(heap.size());
+        for (const Candidate& candidate : heap) picked.push_back(candidate.slot);
+        return RecordView(*columns, std::move(picked));
+    }
+
+    /**
+     * 视图中全部金额之和，只读金额列。
+     * 视图是主日期索引上较大的整日区间时按日期过滤顺序扫描整列（向量化），不沿索引跳着读；
+     * 条数较多时由共享线程池分段求和后按顺序相加。
+     */
+    Money total() const {
+        if (!columns) return Money();
+        const int64_t* amounts = columns->amountColumn().data();
+        if (!slots && index && first == index->begin() && last == index->end() && index->size() == columns->size()) {
+            return Money::fromCents(sumInParts(columns->size(), [&](size_t begin, size_t end) {
+                return SimdKernels::sum(amounts + begin, end - begin);
+            }));
+        }
+        uint32_t from, to;
+        if (preferColumnScan(from, to)) {
+            const uint32_t* dates = columns->dateColumn().data();
+            return Money::fromCents(sumInParts(columns->size(), [&](size_t begin, size_t end) {
+                return SimdKernels::sumInDateRange(dates + begin, amounts + begin, end - begin, from, to).cents;
+            }));
+        }
+        return Money::fromCents(sumInParts(size(), [&](size_t begin, size_t end) {
+            return page(begin, end - begin).sumAmounts();
+        }));
+    }
+
+    /**
+     * 视图是否正好是主日期索引上日期在 [from, to] 内的全部记录，且至少占全部记录的 1/COLUMN_SCAN_SHARE。
+     * 成立时按日期过滤扫描整列与沿索引遍历的结果相同，而且更快
+     */
+    bool preferColumnScan(uint32_t& from, uint32_t& to) const {
+        if (slots || !index || first == last || index->size() != columns->size()) return false;
+        if (size() * COLUMN_SCAN_SHARE < columns->size()) return false;
+        DateIndex::Iterator back = last;
+        --back;
+        from = first->date;
+        to = back->date;
+        return index->lowerBound(from) == first && index->upperBound(to) == last;
+    }
+
+    // 组装成独立的记录对象
+    std::vector<T> toRecords() const {
+        std::vector<T> records;
+        records.reserve(size());
+        for (const RecordRef<T>& ref : *this) records.push_back(ref.toRecord());
+        return records;
+    }
+
+private:
+    const RecordColumns<T>* columns;
+    const DateIndex* index;
+    DateIndex::Iterator first;
+    DateIndex::Iterator last;
+    std::shared_ptr<const std::vector<uint32_t>> slots;
+    size_t slotBegin;   // 槽位列表中属于本视图的区间 [slotBegin, slotEnd)
+    size_t slotEnd;
+
+    // 把 [0, count) 分段交给共享线程池，各段的 sum(begin, end) 按段的顺序相加
+    template <typename SumFn>
+    static int64_t sumInParts(size_t count, SumFn sum) {
+        ThreadPool& pool = ThreadPool::shared();
+        size_t parts = pool.partsFor(count);
+        if (parts == 1) return sum(0, count);
+        std::vector<int64_t> partial(parts);
+        pool.run(parts, [&](size_t i) { partial[i] = sum(count * i / parts, count * (i + 1) / parts); });
+        int64_t cents = 0;
+        for (int64_t part : partial) cents += part;
+        return cents;
+    }
+
+    int64_t sumAmounts() const {
+        int64_t cents = 0;
+        const std::vector<int64_t>& amounts = columns->amountColumn();
+        if (slots) {
+            for (size_t i = slotBegin; i < slotEnd; ++i) cents += amounts[(*slots)[i]];
+        } else {
+            for (DateIndex::Iterator it = first; it != last; ++it) cents += amounts[it->slot];
+        }
+        return cents;
+    }
+};
+
+#endif // RECORD_VIEW_H
@@ -0,0 +1,80 @@
+#ifndef REPORT_ENGINE_H
+#define REPORT_ENGINE_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+#include "FinanceManager.h"
+
+/**
+ * @brief 月度汇总结构
+ */
+struct MonthlySummary {
+    std::string month;      // YYYY-MM
+    Money totalIncome;
+    Money totalExpense;
+    Money netBalance;
+};
+
+/**
+ * @brief 分类汇总结构
+ */
+struct CategorySummary {
+    std::string category;
+    Money total;
+    double percentage;
+
+    CategorySummary() : percentage(0) {}
+
+    // part 占 whole 的百分比，whole 不为正时为0
+    static double percentOf(Money part, Money whole) {
+        return whole.isPositive() ? static_cast<double>(part.getCents()) * 100.0 / static_cast<double>(whole.getCents()) : 0.0;
+    }
+};
+
+/**
+ * @brief 一类记录（收入或支出）的汇总结果
+ */
+struct LedgerReport {
+    Money total;
+    size_t count;
+    std::map<uint32_t, Money> months;          // 键为年月 yyyymm，按时间顺序
+    std::vector<CategorySummary> categories;   // 按金额从大到小
+
+    LedgerReport() : count(0) {}
+};
+
+/**
+ * @brief 一次统计输出用到的全部结果
+ */
+struct FinanceReport {
+    LedgerReport income;
+    LedgerReport expense;
+    std::vector<MonthlySummary> monthly;       // 收入和支出按月份合并
+
+    Money getNetBalance() const { return income.total - expense.total; }
+};
+
+/**
+ * @brief 报表引擎，一次算出月度、分类、总计和条数，交给 ReportGenerator 的各个输出方法
+ *
+ * 整个账本的结果直接取自 LedgerTotals，不读记录；限定日期区间时对区间内的记录只遍历一遍，
+ * 每条记录读一次日期、分类和金额，同时累加到所有汇总中。区间较大时改为按日期过滤顺序扫描整列（向量化），
+ * 记录较多时由共享线程池分段并行统计。
+ */
+class ReportEngine {
+public:
+    explicit ReportEngine(const FinanceManager& mgr);
+
+    // 整个账本
+    FinanceReport build() const;
+    // 日期在 [startDate, endDate] 内的记录
+    FinanceReport build(Date startDate, Date endDate) const;
+
+private:
+    const FinanceManager& manager;
+};
+
+#endif // REPORT_ENGINE_H
@@ -5,37 +5,25 @@
 #include <string>
 #include <map>
 #include "FinanceManager.h"
-
-/**
- * @brief 月度汇总结构
- */
-struct MonthlySummary {
-    std::string month;      // YYYY-MM
-    double totalIncome;
-    double totalExpense;
-    double netBalance;
-    
-    MonthlySummary() : totalIncome(0), totalExpense(0), netBalance(0) {}
-};
-
-/**
- * @brief 分类汇总结构
- */
-struct CategorySummary {
-    std::string category;
-    double total;
-    double percentage;
-    
-    CategorySummary() : total(0), percentage(0) {}
-};
+#include "ReportEngine.h"
 
 /**
  * @brief 报表生成类，提供各种统计报表功能
+ *
+ * 汇总结果由 ReportEngine 一次算出，各输出方法只负责排版；
+ * 完整报表共用同一份结果，每条记录至多读取一次。
  */
 class ReportGenerator {
 private:
     FinanceManager& manager;
 
+    // 按已算好的结果输出
+    void printByMonth(const std::string& title, const std::string& column, const std::string& emptyText, const LedgerReport& report);
+    void printByCategory(const std::string& title, const std::string& emptyText, const LedgerReport& report);
+    void printMonthlySummary(const FinanceReport& report);
+    void printCategoryBreakdown(const FinanceReport& report);
+    void printOverallSummary(const FinanceReport& report);
+
 public:
     // 构造函数
     explicit ReportGenerator(FinanceManager& mgr);
@@ -54,6 +42,11 @@ public:
     void printMonthlySummary();
     void printCategoryBreakdown();
     void printOverallSummary();
+    // 某个日期区间的收支合计、各分类支出以及截至结束日期的结余
+    void printDateRangeSummary(Date startDate, Date endDate);
+    // 完整统计报表（月度汇总、分类统计、总览），全部结果只计算一次
+    void printFullReport();
+    void printFullReport(Date startDate, Date endDate);
 
     // 计算方法
     std::vector<MonthlySummary> calculateMonthlySummary() const;
@@ -61,9 +54,8 @@ public:
     std::vector<CategorySummary> calculateExpenseCategorySummary() const;
     
     // 辅助方法
-    static std::string extractMonth(const std::string& date);
-    double calculateTotalFromRecords(const std::vector<IncomeRecord>& records) const;
-    double calculateTotalFromRecords(const std::vector<ExpenseRecord>& records) const;
+    Money calculateTotalFromRecords(const std::vector<IncomeRecord>& records) const;
+    Money calculateTotalFromRecords(const std::vector<ExpenseRecord>& records) const;
 };
 
 #endif // REPORT_GENERATOR_H
@@ -0,0 +1,50 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <cstdint>
+#include <cstddef>
+#include "LedgerTotals.h"
+
+/**
+ * @brief 列式存储上的向量化统计内核
+ *
+ * 直接在 RecordColumns 的日期、金额、分类列上顺序扫描。每个内核有 AVX2、SSE2 和标量三种实现，
+ * 首次调用时按 CPU 支持的指令集选定，程序不需要用 -mavx2 之类的选项编译，
+ * 非 x86 平台只使用标量实现。三种实现的结果完全相同。
+ *
+ * 日期为打包日期 yyyymmdd，金额为分；金额的绝对值须小于 2^62（Money 可表示的范围远小于此）。
+ * 加载 CSV 时查找分隔符的文本扫描也在这里，与统计内核使用同一套运行时选择。
+ */
+class SimdKernels {
+public:
+    enum class Level { Scalar, SSE2, AVX2 };
+
+    // 全部金额之和
+    static int64_t sum(const int64_t* amounts, size_t count);
+    // 日期在 [first, last] 内的记录的金额之和与条数
+    static LedgerTotals::Bucket sumInDateRange(const uint32_t* dates, const int64_t* amounts, size_t count,
+                                               uint32_t first, uint32_t last);
+    // 第一条金额不小于 threshold 的下标，没有时返回 count
+    static size_t findAtLeast(const int64_t* amounts, size_t count, int64_t threshold);
+    /**
+     * 日期在 [first, last] 内的记录按月份和分类累加（在原有值上累加）。
+     * months 的下标为 yyyymm - first/100，长度至少为 monthSpan(first, last)；
+     * categoryBuckets 的下标为分类 ID，长度须大于出现的最大分类 ID。
+     */
+    static void histogram(const uint32_t* dates, const int64_t* amounts, const uint32_t* categories, size_t count,
+                          uint32_t first, uint32_t last, LedgerTotals::Bucket* months, LedgerTotals::Bucket* categoryBuckets);
+    // [p, end) 中第一个逗号、引号、\r 或 \n 的位置，没有时返回 end
+    static const char* findCsvSpecial(const char* p, const char* end);
+
+    // histogram 所需的月份桶个数（按 yyyymm 的差值计，跨年时中间有不会用到的桶）
+    static size_t monthSpan(uint32_t first, uint32_t last) { return last / 100 - first / 100 + 1; }
+
+    // 当前使用的实现
+    static Level getLevel();
+    static const char* getLevelName(Level level);
+    // 改用不高于 level 且 CPU 支持的实现，返回实际选用的级别。
+    // 供基准测试对比各实现使用，调用时不能有其他线程正在使用这些内核
+    static Level setLevel(Level level);
+};
+
+#endif // SIMD_KERNELS_H
@@ -0,0 +1,158 @@
+#ifndef STRING_DICTIONARY_H
+#define STRING_DICTIONARY_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief 预定义分类的编译期完美哈希
+ *
+ * 预定义分类在分类字典中占用固定的 ID 0 ~ COUNT-1，
+ * 顺序与 InputHelper::getIncomeCategories / getExpenseCategories 中的名称一致。
+ * 哈希种子保证这些名称落在互不相同的槽位上，由下方的 static_assert 在编译期验证。
+ */
+namespace CategoryHash {
+
+constexpr const char* NAMES[] = {
+    "工资", "奖金", "投资收益", "兼职收入", "礼金", "其他",
+    "餐饮", "住房", "交通", "购物", "娱乐", "医疗", "教育", "水电费", "通讯费"
+};
+constexpr size_t COUNT = sizeof(NAMES) / sizeof(NAMES[0]);
+constexpr unsigned SLOT_BITS = 4;
+constexpr size_t SLOT_COUNT = size_t(1) << SLOT_BITS;
+constexpr uint32_t SEED = 9589;
+
+constexpr size_t length(const char* text) {
+    size_t n = 0;
+    while (text[n] != '\0') ++n;
+    return n;
+}
+
+// 带种子的 FNV-1a，取高位作为槽位
+constexpr size_t slotOf(const char* data, size_t size) {
+    uint32_t hash = 2166136261u ^ SEED;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash >> (32 - SLOT_BITS);
+}
+
+struct SlotTable {
+    signed char ids[SLOT_COUNT];
+};
+
+constexpr SlotTable buildSlots() {
+    SlotTable table{};
+    for (size_t i = 0; i < SLOT_COUNT; ++i) table.ids[i] = -1;
+    for (size_t i = 0; i < COUNT; ++i) table.ids[slotOf(NAMES[i], length(NAMES[i]))] = static_cast<signed char>(i);
+    return table;
+}
+
+constexpr SlotTable SLOTS = buildSlots();
+
+constexpr bool isPerfect() {
+    for (size_t i = 0; i < COUNT; ++i) {
+        if (SLOTS.ids[slotOf(NAMES[i], length(NAMES[i]))] != static_cast<signed char>(i)) return false;
+    }
+    return true;
+}
+static_assert(isPerfect(), "预定义分类的哈希出现冲突，请更换 SEED");
+
+constexpr bool equals(const char* data, size_t size, const char* name) {
+    for (size_t i = 0; i < size; ++i) {
+        if (name[i] == '\0' || name[i] != data[i]) return false;
+    }
+    return name[size] == '\0';
+}
+
+// 预定义分类的 ID，不是预定义分类时为 -1；可在运行期查找，也可在编译期求值
+constexpr int find(const char* data, size_t size) {
+    return SLOTS.ids[slotOf(data, size)] >= 0 && equals(data, size, NAMES[SLOTS.ids[slotOf(data, size)]])
+        ? SLOTS.ids[slotOf(data, size)] : -1;
+}
+
+constexpr int idOf(const char* text) {
+    return find(text, length(text));
+}
+static_assert(idOf("餐饮") == 6 && idOf("其他") == 5 && idOf("房租") == -1, "预定义分类的 ID 必须固定");
+
+} // namespace CategoryHash
+
+/**
+ * @brief 字符串驻留字典，把重复出现的文本映射为从0开始的连续整数 ID
+ *
+ * 分类、支付对象和收入来源高度重复，记录中只保存 ID，文本在字典中只存一份。
+ * ID 一经分配永不回收，text() 返回的引用在程序运行期间始终有效。空串固定占用 getEmptyId()。
+ * intern() 按哈希分片加锁，可以在并行加载的多个线程中同时调用；text() 不加锁。
+ * 最多容纳 CAPACITY 个不同的文本，超出后 tryIntern() 返回 NONE，intern() 抛出 std::length_error。
+ */
+class StringDictionary {
+public:
+    static const uint32_t NONE = 0xFFFFFFFFu;
+    static const uint32_t CAPACITY = 1u << 26;
+
+    // seed 中的条目依次占用 ID 0 ~ seedCount-1，由 predefined 查找（返回 -1 表示不在其中），不进入分片
+    StringDictionary(const char* const* seed = nullptr, size_t seedCount = 0,
+                     int (*predefined)(const char*, size_t) = nullptr);
+    ~StringDictionary();
+    StringDictionary(const StringDictionary&) = delete;
+    StringDictionary& operator=(const StringDictionary&) = delete;
+
+    // 返回文本对应的 ID，不存在时分配新 ID；字典已满时抛出 std::length_error
+    uint32_t intern(const char* data, size_t size);
+    uint32_t intern(const std::string& text);
+    // 同 intern()，但字典已满时返回 NONE，供加载数据时按错误行处理
+    uint32_t tryIntern(const char* data, size_t size);
+    uint32_t tryIntern(const std::string& text);
+    // 只查找不分配，不存在时返回 NONE
+    uint32_t find(const char* data, size_t size) const;
+    uint32_t find(const std::string& text) const;
+
+    const std::string& text(uint32_t id) const;
+    uint32_t getEmptyId() const { return emptyId; }
+    // 已分配的 ID 个数，可作为按 ID 分组的数组大小
+    uint32_t size() const;
+
+    // 全局字典：分类（预定义分类占用固定的前几个 ID）以及支付对象/收入来源
+    static StringDictionary& categories();
+    static StringDictionary& parties();
+
+private:
+    static const unsigned SHARD_BITS = 4;
+    static const size_t SHARD_COUNT = size_t(1) << SHARD_BITS;
+    static const unsigned CHUNK_BITS = 12;
+    static const size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+    static const size_t MAX_CHUNKS = CAPACITY >> CHUNK_BITS;
+
+    struct Slot {
+        uint32_t hash;
+        uint32_t id;    // NONE 表示空槽
+    };
+
+    // 每个分片是一张开放寻址表，只存哈希和 ID，文本在分块存储中
+    struct Shard {
+        mutable std::mutex mutex;
+        std::vector<Slot> slots;
+        size_t used = 0;
+    };
+
+    Shard shards[SHARD_COUNT];
+    // 文本按 ID 分块存放，块一旦分配不再移动，读取时无需加锁
+    std::atomic<std::string*> chunks[MAX_CHUNKS];
+    std::atomic<uint32_t> count;
+    int (*predefined)(const char* data, size_t size);
+    uint32_t emptyId;
+
+    static uint32_t hashOf(const char* data, size_t size);
+    uint32_t findInShard(const Shard& shard, uint32_t hash, const char* data, size_t size) const;
+    void insertIntoShard(Shard& shard, uint32_t hash, uint32_t id);
+    // 分配下一个 ID 并存入文本，字典已满时返回 NONE
+    uint32_t append(const char* data, size_t size);
+};
+
+#endif // STRING_DICTIONARY_H
@@ -0,0 +1,55 @@
+#ifndef TEXT_INDEX_H
+#define TEXT_INDEX_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief 按字符二元组（bigram）建立的全文倒排索引
+ *
+ * 文本按 UTF-8 解码为字符，相邻两个字符组成一个词元，每个词元对应一份按记录ID升序的倒排表。
+ * 中文按字切分后二元组就是常见的检索单位，英文和数字同样按字符处理。
+ * 查询时取关键词全部二元组的倒排表求交集，得到的只是候选记录，调用方仍需核对原文是否真的包含关键词。
+ */
+class TextIndex {
+public:
+    TextIndex();
+
+    void clear();
+    void add(int id, const std::string& text);
+    void remove(int id, const std::string& text);
+    // 批量加载时先 append 再统一 finish，避免每次插入都维护顺序
+    void append(int id, const std::string& text);
+    void finish();
+
+    /**
+     * 取包含关键词全部二元组的候选记录ID（升序）。
+     * 关键词不足两个字符时索引无法缩小范围，返回 false，调用方应直接逐条核对。
+     */
+    bool candidates(const std::string& keyword, std::vector<int>& ids) const;
+
+    size_t gramCount() const { return postings.size(); }
+
+private:
+    static const size_t CACHE_SIZE = 256;
+
+    struct CacheEntry {
+        uint64_t gram;
+        std::vector<int>* list;
+    };
+
+    std::unordered_map<uint64_t, std::vector<int>> postings;
+    // 批量追加时最近用到的倒排表；常见二元组反复出现，命中时省去一次哈希表查找。
+    // unordered_map 的元素地址在扩容时不变，缓存的指针始终有效
+    CacheEntry cache[CACHE_SIZE];
+
+    void resetCache();
+
+    // 文本中出现的全部二元组，已去重
+    static void collectGrams(const std::string& text, std::vector<uint64_t>& grams);
+};
+
+#endif // TEXT_INDEX_H
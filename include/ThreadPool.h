@@ -0,0 +1,65 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief 供统计并行使用的共享线程池
+ *
+ * run(n, task) 把 0 ~ n-1 号任务分给工作线程和调用线程一起执行，全部完成后返回；
+ * 每个任务写自己的结果槽位，由调用方按编号顺序合并，结果与串行计算一致。
+ * 多个线程同时调用 run 时依次执行；在任务中再次调用 run 时直接在当前线程上串行执行。
+ * 任务不应抛出异常。
+ */
+class ThreadPool {
+public:
+    // 每份至少这么多条记录才值得交给另一个线程，数据量更小时 partsFor 返回1（串行）
+    static const size_t PARALLEL_GRAIN = 32768;
+
+    // threads 为参与计算的线程总数（含调用线程），为0或1时不启动工作线程
+    explicit ThreadPool(unsigned threads);
+    ~ThreadPool();
+
+    // 禁止拷贝
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 参与计算的线程总数
+    size_t size() const { return workers.size() + 1; }
+
+    // count 条数据按每份至少 grain 条切分时的份数，不超过线程总数
+    size_t partsFor(size_t count, size_t grain = PARALLEL_GRAIN) const {
+        return std::max<size_t>(1, std::min(size(), count / std::max<size_t>(grain, 1)));
+    }
+
+    void run(size_t tasks, const std::function<void(size_t)>& task);
+
+    // 全局线程池，线程数取 CPU 核数，首次使用时创建
+    static ThreadPool& shared();
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex runMutex;                // 同一时间只执行一批任务
+    std::mutex mutex;
+    std::condition_variable wake;       // 通知工作线程有新的一批任务或需要退出
+    std::condition_variable finished;   // 通知调用线程全部工作线程已完成本批任务
+    const std::function<void(size_t)>* job;
+    size_t jobTasks;
+    std::atomic<size_t> nextTask;
+    size_t busyWorkers;
+    uint64_t generation;
+    bool stopping;
+
+    void workerLoop();
+    void drain(const std::function<void(size_t)>& task, size_t tasks);
+};
+
+#endif // THREAD_POOL_H
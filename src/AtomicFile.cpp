@@ -0,0 +1,145 @@
+#include "AtomicFile.h"
+#include <cstdio>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+const char* const AtomicFile::TEMP_SUFFIX = ".tmp";
+
+#ifdef _WIN32
+
+bool AtomicFile::write(const std::string& path, const char* data, size_t size) {
+    std::string tempPath = tempPathOf(path);
+    HANDLE handle = CreateFileA(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+
+    bool ok = true;
+    while (ok && size > 0) {
+        DWORD chunk = static_cast<DWORD>(size > 0x40000000 ? 0x40000000 : size);
+        DWORD written = 0;
+        ok = WriteFile(handle, data, chunk, &written, nullptr) && written > 0;
+        data += written;
+        size -= written;
+    }
+    ok = ok && FlushFileBuffers(handle);
+    CloseHandle(handle);
+    if (!ok) { DeleteFileA(tempPath.c_str()); return false; }
+    return MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+bool AtomicFile::commit(const std::string& tempPath, const std::string& path) {
+    HANDLE handle = CreateFileA(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    bool ok = FlushFileBuffers(handle) != 0;
+    CloseHandle(handle);
+    if (!ok) { DeleteFileA(tempPath.c_str()); return false; }
+    return MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+bool AtomicFile::appendSynced(const std::string& path, const char* data, size_t size, size_t* written) {
+    if (written) *written = 0;
+    HANDLE handle = CreateFileA(path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ, nullptr, OPEN_ALWAYS,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    bool ok = true;
+    while (ok && size > 0) {
+        DWORD chunk = static_cast<DWORD>(size > 0x40000000 ? 0x40000000 : size);
+        DWORD count = 0;
+        ok = WriteFile(handle, data, chunk, &count, nullptr) && count > 0;
+        data += count;
+        size -= count;
+        if (written) *written += count;
+    }
+    ok = ok && FlushFileBuffers(handle);
+    CloseHandle(handle);
+    return ok;
+}
+
+#else
+
+// 改名只有在所在目录也刷盘后才算持久化
+static void syncParentDirectory(const std::string& path) {
+    size_t pos = path.find_last_of('/');
+    std::string dir = pos == std::string::npos ? std::string(".") : path.substr(0, pos == 0 ? 1 : pos);
+    int fd = ::open(dir.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    ::fsync(fd);
+    ::close(fd);
+}
+
+static bool syncAndRename(int fd, const std::string& tempPath, const std::string& path) {
+    bool ok = ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    syncParentDirectory(path);
+    return true;
+}
+
+bool AtomicFile::write(const std::string& path, const char* data, size_t size) {
+    std::string tempPath = tempPathOf(path);
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written <= 0) {
+            ::close(fd);
+            std::remove(tempPath.c_str());
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return syncAndRename(fd, tempPath, path);
+}
+
+bool AtomicFile::commit(const std::string& tempPath, const std::string& path) {
+    int fd = ::open(tempPath.c_str(), O_WRONLY);
+    if (fd < 0) return false;
+    return syncAndRename(fd, tempPath, path);
+}
+
+bool AtomicFile::appendSynced(const std::string& path, const char* data, size_t size, size_t* written) {
+    if (written) *written = 0;
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) return false;
+    bool ok = true;
+    while (ok && size > 0) {
+        ssize_t count = ::write(fd, data, size);
+        ok = count > 0;
+        if (ok) {
+            data += count;
+            size -= static_cast<size_t>(count);
+            if (written) *written += static_cast<size_t>(count);
+        }
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    return ok;
+}
+
+#endif
+
+bool AtomicFile::write(const std::string& path, const std::string& content) {
+    return write(path, content.data(), content.size());
+}
+
+std::string AtomicFile::tempPathOf(const std::string& path) {
+    return path + TEMP_SUFFIX;
+}
+
+bool AtomicFile::recover(const std::string& path) {
+    return std::remove(tempPathOf(path).c_str()) == 0;
+}
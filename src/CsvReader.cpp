@@ -0,0 +1,218 @@
+#include "CsvReader.h"
+#include "StringDictionary.h"
+#include "SimdKernels.h"
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+// 逗号、引号和换行的查找由 SimdKernels 按 CPU 在运行时选用 AVX2/SSE2/标量实现
+const char* CsvReader::findSpecial(const char* p, const char* end) {
+    return SimdKernels::findCsvSpecial(p, end);
+}
+
+bool CsvField::equals(const char* text) const {
+    size_t len = std::strlen(text);
+    return !escaped && size == len && std::memcmp(data, text, len) == 0;
+}
+
+std::string CsvField::toString() const {
+    std::string result;
+    assignTo(result);
+    return result;
+}
+
+void CsvField::assignTo(std::string& out) const {
+    if (!escaped) { out.assign(data, size); return; }
+    // 按引号分段整块拷贝，"" 只保留一个
+    out.clear();
+    out.reserve(size);
+    const char* p = data;
+    const char* end = data + size;
+    while (p < end) {
+        const char* quote = static_cast<const char*>(std::memchr(p, '"', static_cast<size_t>(end - p)));
+        if (!quote) { out.append(p, end); break; }
+        out.append(p, quote + 1);
+        p = quote + 1;
+        if (p < end && *p == '"') ++p;
+    }
+}
+
+ParseStatus CsvField::parseInt(int& out) const {
+    return NumberParser::parseInt(data, size, out);
+}
+
+ParseStatus CsvField::parseAmount(Money& out) const {
+    return Money::parse(data, size, out);
+}
+
+ParseStatus CsvField::intern(StringDictionary& dictionary, uint32_t& out) const {
+    out = escaped ? dictionary.tryIntern(toString()) : dictionary.tryIntern(data, size);
+    return out == StringDictionary::NONE ? ParseStatus::TooManyStrings : ParseStatus::Ok;
+}
+
+ParseStatus CsvField::parseDate(Date& out) const {
+    // 表格软件会把年份按千分位显示，导出成 "2,026-01-07"；去掉这个逗号再解析
+    if (size == 11 && data[1] == ',') {
+        char repaired[10];
+        repaired[0] = data[0];
+        std::copy(data + 2, data + 11, repaired + 1);
+        return Date::parse(repaired, sizeof(repaired), out);
+    }
+    return Date::parse(data, size, out);
+}
+
+CsvReader::CsvReader(const char* begin, const char* end) : cur(begin), last(end), nextLine(1), recordLine(0) {}
+
+bool CsvReader::next(CsvField* fields, size_t& fieldCount) {
+    while (cur < last) {
+        fieldCount = 0;
+        const char* fieldStart = cur;
+        bool inQuotes = false;
+        bool hasQuote = false;
+        size_t embeddedLines = 0;
+        const char* p = cur;
+
+        // 结束一个字段：去掉外层引号并记录是否需要还原转义
+        auto finishField = [&](const char* fieldEnd) {
+            if (fieldEnd > fieldStart && fieldEnd[-1] == '\r') --fieldEnd;
+            if (fieldCount < MAX_FIELDS) {
+                CsvField& f = fields[fieldCount];
+                f.data = fieldStart;
+                f.size = static_cast<size_t>(fieldEnd - fieldStart);
+                if (f.size >= 2 && f.data[0] == '"' && fieldEnd[-1] == '"') {
+                    ++f.data;
+                    f.size -= 2;
+                }
+                f.escaped = hasQuote && std::memchr(f.data, '"', f.size) != nullptr;
+            }
+            ++fieldCount;
+        };
+
+        // 引号外跳到下一个特殊字符，引号内只需找下一个引号
+        while (p < last) {
+            if (inQuotes) {
+                const char* quote = static_cast<const char*>(std::memchr(p, '"', static_cast<size_t>(last - p)));
+                if (!quote) quote = last;
+                // 引号内的换行也占行号
+                for (const char* nl = p; (nl = static_cast<const char*>(std::memchr(nl, '\n', quote - nl))) != nullptr; ++nl) {
+                    ++embeddedLines;
+                }
+                if (quote == last) { p = last; break; }
+                inQuotes = false;
+                p = quote + 1;
+                continue;
+            }
+            p = findSpecial(p, last);
+            if (p == last) break;
+            char c = *p;
+            if (c == '"') {
+                inQuotes = true;
+                hasQuote = true;
+            } else if (c == ',') {
+                finishField(p);
+                fieldStart = p + 1;
+                hasQuote = false;
+            } else if (c == '\n') {
+                break;
+            }
+            ++p;
+        }
+
+        bool blank = (fieldCount == 0 && (p == cur || (p == cur + 1 && *cur == '\r')));
+        if (!blank) finishField(p);
+        cur = (p < last) ? p + 1 : last;
+        recordLine = nextLine;
+        nextLine += 1 + embeddedLines;
+        if (!blank) return true;
+    }
+    return false;
+}
+
+// 形如 1~3 位数字（可带符号）的千分位首组
+static bool isLeadingGroup(const CsvField& f) {
+    size_t i = (f.size > 0 && (f.data[0] == '-' || f.data[0] == '+')) ? 1 : 0;
+    if (f.escaped || f.size - i < 1 || f.size - i > 3) return false;
+    for (; i < f.size; ++i) if (f.data[i] < '0' || f.data[i] > '9') return false;
+    return true;
+}
+
+// 形如 3 位数字的后续组；最后一组可以带小数部分
+static bool isFollowingGroup(const CsvField& f, bool last) {
+    if (f.escaped || f.size < 3) return false;
+    for (size_t i = 0; i < 3; ++i) if (f.data[i] < '0' || f.data[i] > '9') return false;
+    if (f.size == 3) return true;
+    if (!last || f.data[3] != '.') return false;
+    for (size_t i = 4; i < f.size; ++i) if (f.data[i] < '0' || f.data[i] > '9') return false;
+    return true;
+}
+
+size_t CsvReader::joinGroupedNumber(CsvField* fields, size_t count, size_t index, size_t expected) {
+    if (count <= expected || count > MAX_FIELDS) return 0;
+    size_t extra = count - expected;
+    if (!isLeadingGroup(fields[index])) return 0;
+    for (size_t k = 1; k <= extra; ++k) {
+        const CsvField& f = fields[index + k];
+        // 各组必须在原始缓冲区中紧挨着，中间只隔一个逗号（排除带引号的字段）
+        if (f.data != fields[index + k - 1].data + fields[index + k - 1].size + 1) return 0;
+        if (!isFollowingGroup(f, k == extra)) return 0;
+    }
+    const CsvField& lastGroup = fields[index + extra];
+    fields[index].size = static_cast<size_t>(lastGroup.data + lastGroup.size - fields[index].data);
+    for (size_t i = index + 1; i + extra < count; ++i) fields[i] = fields[i + extra];
+    return extra;
+}
+
+std::vector<const char*> CsvReader::splitRecords(const char* begin, const char* end, size_t parts) {
+    std::vector<const char*> bounds(1, begin);
+    const size_t total = static_cast<size_t>(end - begin);
+    const char* p = begin;
+    bool inQuotes = false;
+
+    for (size_t k = 1; k < parts; ++k) {
+        const char* target = begin + total / parts * k;
+        if (target <= bounds.back()) continue;
+
+        // 跳到目标位置，只需数引号来维护是否处于引号内
+        while (p < target) {
+            const char* quote = static_cast<const char*>(std::memchr(p, '"', static_cast<size_t>(target - p)));
+            if (!quote) { p = target; break; }
+            inQuotes = !inQuotes;
+            p = quote + 1;
+        }
+        // 从目标位置向后找到第一个不在引号内的换行
+        for (; p < end; ++p) {
+            if (*p == '"') inQuotes = !inQuotes;
+            else if (*p == '\n' && !inQuotes) break;
+        }
+        if (p >= end) break;
+        bounds.push_back(++p);
+    }
+    bounds.push_back(end);
+    return bounds;
+}
+
+bool CsvWriter::needsQuoting(const char* data, size_t size) {
+    return CsvReader::findSpecial(data, data + size) != data + size;
+}
+
+void CsvWriter::appendField(std::string& out, const std::string& field) {
+    const char* p = field.data();
+    const char* end = p + field.size();
+    if (!needsQuoting(p, field.size())) { out += field; return; }
+
+    out += '"';
+    while (p < end) {
+        const char* quote = static_cast<const char*>(std::memchr(p, '"', static_cast<size_t>(end - p)));
+        if (!quote) { out.append(p, end); break; }
+        out.append(p, quote + 1);
+        out += '"';
+        p = quote + 1;
+    }
+    out += '"';
+}
+
+std::string CsvWriter::escapeField(const std::string& field) {
+    std::string result;
+    appendField(result, field);
+    return result;
+}
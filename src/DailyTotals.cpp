@@ -0,0 +1,103 @@
+#include "DailyTotals.h"
+#include <algorithm>
+
+const int DailyTotals::BLOCK_DAYS;
+const uint32_t DailyTotals::NO_BLOCK;
+
+int DailyTotals::dayCount() {
+    static const int count = Date::fromParts(Date::MAX_YEAR, 12, 31).getDayNumber() + 1;
+    return count;
+}
+
+DailyTotals::DailyTotals() : firstBlock(0) {}
+
+void DailyTotals::clear() {
+    firstBlock = 0;
+    blocks.clear();
+    days.clear();
+    blockTree.clear();
+}
+
+int DailyTotals::clampDay(Date date) {
+    return std::min(std::max(date.getDayNumber(), 0), dayCount() - 1);
+}
+
+int64_t& DailyTotals::slotOf(int day) {
+    int block = day / BLOCK_DAYS;
+    if (blocks.empty()) {
+        firstBlock = block;
+        blocks.push_back(NO_BLOCK);
+        blockTree.clear();
+    } else if (block < firstBlock) {
+        blocks.insert(blocks.begin(), static_cast<size_t>(firstBlock - block), NO_BLOCK);
+        firstBlock = block;
+        blockTree.clear();
+    } else if (block - firstBlock >= static_cast<int>(blocks.size())) {
+        blocks.resize(static_cast<size_t>(block - firstBlock) + 1, NO_BLOCK);
+        blockTree.clear();
+    }
+    uint32_t& start = blocks[static_cast<size_t>(block - firstBlock)];
+    if (start == NO_BLOCK) {
+        start = static_cast<uint32_t>(days.size());
+        days.resize(days.size() + BLOCK_DAYS, 0);
+    }
+    return days[start + static_cast<size_t>(day % BLOCK_DAYS)];
+}
+
+void DailyTotals::rebuildTree() {
+    // 先放入各块合计，再把每个节点并入父节点，得到的就是树状数组
+    blockTree.assign(blocks.size() + 1, 0);
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (blocks[i] == NO_BLOCK) continue;
+        for (int d = 0; d < BLOCK_DAYS; ++d) blockTree[i + 1] += days[blocks[i] + static_cast<size_t>(d)];
+    }
+    for (size_t i = 1; i < blockTree.size(); ++i) {
+        size_t parent = i + (i & (0 - i));
+        if (parent < blockTree.size()) blockTree[parent] += blockTree[i];
+    }
+}
+
+void DailyTotals::add(Date date, int64_t cents) {
+    int day = clampDay(date);
+    slotOf(day) += cents;
+    if (blockTree.empty()) {
+        rebuildTree();
+        return;
+    }
+    for (size_t i = static_cast<size_t>(day / BLOCK_DAYS - firstBlock) + 1; i < blockTree.size(); i += i & (0 - i)) {
+        blockTree[i] += cents;
+    }
+}
+
+void DailyTotals::append(Date date, int64_t cents) {
+    slotOf(clampDay(date)) += cents;
+}
+
+void DailyTotals::finish() {
+    rebuildTree();
+}
+
+int64_t DailyTotals::prefix(int day) const {
+    if (blocks.empty() || day < 0) return 0;
+    day = std::min(day, dayCount() - 1);
+    int block = day / BLOCK_DAYS - firstBlock;
+    if (block < 0) return 0;
+    // 覆盖范围之后的日期即全部合计
+    size_t wholeBlocks = std::min(static_cast<size_t>(block), blocks.size());
+    int64_t sum = 0;
+    for (size_t i = wholeBlocks; i > 0; i -= i & (0 - i)) sum += blockTree[i];
+    if (wholeBlocks < blocks.size() && blocks[wholeBlocks] != NO_BLOCK) {
+        const int64_t* blockDays = days.data() + blocks[wholeBlocks];
+        for (int i = 0; i <= day % BLOCK_DAYS; ++i) sum += blockDays[i];
+    }
+    return sum;
+}
+
+Money DailyTotals::totalThrough(Date date) const {
+    return Money::fromCents(prefix(date.getDayNumber()));
+}
+
+Money DailyTotals::totalBetween(Date startDate, Date endDate) const {
+    if (startDate > endDate) return Money();
+    return Money::fromCents(prefix(endDate.getDayNumber()) - prefix(startDate.getDayNumber() - 1));
+}
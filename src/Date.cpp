@@ -0,0 +1,106 @@
+#include "Date.h"
+#include <ctime>
+
+static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// 把 count 位数字写到 p 开始的位置
+static void writeDigits(char* p, uint32_t value, int count) {
+    for (int i = count - 1; i >= 0; --i) {
+        p[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+Date Date::fromParts(int year, int month, int day) {
+    if (!isValid(year, month, day)) return Date();
+    return Date(static_cast<uint32_t>(year * 10000 + month * 100 + day));
+}
+
+Date Date::today() {
+    time_t now = time(nullptr);
+    tm* ltm = localtime(&now);
+    return fromParts(1900 + ltm->tm_year, 1 + ltm->tm_mon, ltm->tm_mday);
+}
+
+ParseStatus Date::parse(const char* data, size_t size, Date& out) {
+    const char* p = data;
+    const char* end = data + size;
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    while (end > p && (end[-1] == ' ' || end[-1] == '\t')) --end;
+    if (p == end) return ParseStatus::Empty;
+
+    if (end - p != 10 || p[4] != '-' || p[7] != '-') return ParseStatus::InvalidDate;
+    uint32_t digits[8];
+    int n = 0;
+    for (int i = 0; i < 10; ++i) {
+        if (i == 4 || i == 7) continue;
+        if (!isDigit(p[i])) return ParseStatus::InvalidDate;
+        digits[n++] = static_cast<uint32_t>(p[i] - '0');
+    }
+    int year = static_cast<int>(digits[0] * 1000 + digits[1] * 100 + digits[2] * 10 + digits[3]);
+    int month = static_cast<int>(digits[4] * 10 + digits[5]);
+    int day = static_cast<int>(digits[6] * 10 + digits[7]);
+    if (!isValid(year, month, day)) return ParseStatus::InvalidDate;
+    out = Date(static_cast<uint32_t>(year * 10000 + month * 100 + day));
+    return ParseStatus::Ok;
+}
+
+ParseStatus Date::parse(const std::string& text, Date& out) {
+    return parse(text.data(), text.size(), out);
+}
+
+bool Date::isLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+}
+
+int Date::getDaysInMonth(int year, int month) {
+    static const int daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month == 2 && isLeapYear(year)) return 29;
+    return daysInMonth[month - 1];
+}
+
+bool Date::isValid(int year, int month, int day) {
+    if (year < MIN_YEAR || year > MAX_YEAR) return false;
+    if (month < 1 || month > 12) return false;
+    return day >= 1 && day <= getDaysInMonth(year, month);
+}
+
+// 公历日期到某一固定纪元的天数（按3月为一年之始计算，闰日落在年末）
+static int64_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2 ? 1 : 0;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yearOfEra = year - era * 400;
+    int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra;
+}
+
+int Date::getDayNumber() const {
+    static const int64_t epoch = daysFromCivil(MIN_YEAR, 1, 1);
+    return static_cast<int>(daysFromCivil(getYear(), getMonth(), getDay()) - epoch);
+}
+
+std::string Date::toString() const {
+    std::string text;
+    appendTo(text);
+    return text;
+}
+
+void Date::appendTo(std::string& out) const {
+    if (packed == 0) return;
+    char buffer[10];
+    writeDigits(buffer, packed / 10000, 4);
+    buffer[4] = '-';
+    writeDigits(buffer + 5, packed / 100 % 100, 2);
+    buffer[7] = '-';
+    writeDigits(buffer + 8, packed % 100, 2);
+    out.append(buffer, sizeof(buffer));
+}
+
+std::string Date::formatYearMonth(uint32_t yearMonth) {
+    char buffer[7];
+    writeDigits(buffer, yearMonth / 100, 4);
+    buffer[4] = '-';
+    writeDigits(buffer + 5, yearMonth % 100, 2);
+    return std::string(buffer, sizeof(buffer));
+}
@@ -0,0 +1,118 @@
+#include "DateIndex.h"
+#include <algorithm>
+#include <climits>
+
+const size_t DateIndex::BLOCK_SIZE;
+
+DateIndex::DateIndex() : count(0) {}
+
+void DateIndex::clear() {
+    blocks.clear();
+    count = 0;
+}
+
+void DateIndex::build(std::vector<Entry> entries) {
+    clear();
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return less(a, b.date, b.id); });
+    // 初始每块只填一半，给后续插入留出空间
+    size_t fill = BLOCK_SIZE / 2;
+    for (size_t begin = 0; begin < entries.size(); begin += fill) {
+        size_t end = std::min(entries.size(), begin + fill);
+        blocks.emplace_back(entries.begin() + begin, entries.begin() + end);
+        blocks.back().reserve(BLOCK_SIZE);
+    }
+    count = entries.size();
+}
+
+size_t DateIndex::findBlock(uint32_t date, int id) const {
+    // 第一个末尾条目不小于该键的块；都小于时落在最后一块
+    size_t low = 0, high = blocks.size();
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (less(blocks[mid].back(), date, id)) low = mid + 1;
+        else high = mid;
+    }
+    return low < blocks.size() ? low : blocks.size() - 1;
+}
+
+DateIndex::Iterator DateIndex::normalize(size_t block, size_t offset) const {
+    if (block < blocks.size() && offset == blocks[block].size()) return Iterator(this, block + 1, 0);
+    return Iterator(this, block, offset);
+}
+
+DateIndex::Iterator DateIndex::locate(uint32_t date, int id) const {
+    if (blocks.empty()) return end();
+    size_t block = findBlock(date, id);
+    const std::vector<Entry>& entries = blocks[block];
+    auto it = std::lower_bound(entries.begin(), entries.end(), 0, [date, id](const Entry& e, int) { return less(e, date, id); });
+    return normalize(block, static_cast<size_t>(it - entries.begin()));
+}
+
+DateIndex::Iterator DateIndex::lowerBound(uint32_t date) const {
+    return locate(date, INT_MIN);
+}
+
+DateIndex::Iterator DateIndex::upperBound(uint32_t date) const {
+    if (date == UINT32_MAX) return end();
+    return locate(date + 1, INT_MIN);
+}
+
+size_t DateIndex::distance(Iterator first, Iterator last) const {
+    if (first.block == last.block) return last.offset - first.offset;
+    size_t total = blocks[first.block].size() - first.offset;
+    for (size_t block = first.block + 1; block < last.block; ++block) total += blocks[block].size();
+    return total + last.offset;
+}
+
+DateIndex::Iterator DateIndex::advance(Iterator it, size_t n, Iterator limit) const {
+    while (n > 0 && it != limit) {
+        size_t blockEnd = it.block == limit.block ? limit.offset : blocks[it.block].size();
+        size_t step = std::min(n, blockEnd - it.offset);
+        it.offset += step;
+        n -= step;
+        if (it.offset == blocks[it.block].size()) { ++it.block; it.offset = 0; }
+    }
+    return it;
+}
+
+void DateIndex::insert(const Entry& entry) {
+    if (blocks.empty()) {
+        blocks.emplace_back();
+        blocks.back().reserve(BLOCK_SIZE);
+    }
+    size_t block = findBlock(entry.date, entry.id);
+    std::vector<Entry>& entries = blocks[block];
+    auto it = std::lower_bound(entries.begin(), entries.end(), 0,
+                               [&entry](const Entry& e, int) { return less(e, entry.date, entry.id); });
+    entries.insert(it, entry);
+    ++count;
+    // 块满时把后一半移到新块
+    if (entries.size() >= BLOCK_SIZE) {
+        std::vector<Entry> upper(entries.begin() + BLOCK_SIZE / 2, entries.end());
+        upper.reserve(BLOCK_SIZE);
+        entries.resize(BLOCK_SIZE / 2);
+        blocks.insert(blocks.begin() + block + 1, std::move(upper));
+    }
+}
+
+bool DateIndex::erase(uint32_t date, int id) {
+    if (blocks.empty()) return false;
+    size_t block = findBlock(date, id);
+    std::vector<Entry>& entries = blocks[block];
+    auto it = std::lower_bound(entries.begin(), entries.end(), 0, [date, id](const Entry& e, int) { return less(e, date, id); });
+    if (it == entries.end() || it->date != date || it->id != id) return false;
+    entries.erase(it);
+    --count;
+    if (entries.empty()) blocks.erase(blocks.begin() + block);
+    return true;
+}
+
+bool DateIndex::moveSlot(uint32_t date, int id, uint32_t slot) {
+    if (blocks.empty()) return false;
+    size_t block = findBlock(date, id);
+    std::vector<Entry>& entries = blocks[block];
+    auto it = std::lower_bound(entries.begin(), entries.end(), 0, [date, id](const Entry& e, int) { return less(e, date, id); });
+    if (it == entries.end() || it->date != date || it->id != id) return false;
+    it->slot = slot;
+    return true;
+}
@@ -36,13 +36,13 @@ void DisplayHelper::printSeparator(int width, char ch) {
 }
 
 void DisplayHelper::printDoubleSeparator(int width) {
-    std::cout << "╔" << std::string(width - 2, '═') << "╗" << std::endl;
+    std::cout << "╔" << repeat("═", width - 2) << "╗" << std::endl;
 }
 
 void DisplayHelper::printTableHeader(const std::vector<std::string>& headers, const std::vector<int>& widths) {
     std::cout << "┌";
     for (size_t i = 0; i < widths.size(); ++i) {
-        std::cout << std::string(widths[i], '─');
+        std::cout << repeat("─", widths[i]);
         if (i < widths.size() - 1) std::cout << "┬";
     }
     std::cout << "┐" << std::endl;
@@ -55,7 +55,7 @@ void DisplayHelper::printTableHeader(const std::vector<std::string>& headers, co
     
     std::cout << "├";
     for (size_t i = 0; i < widths.size(); ++i) {
-        std::cout << std::string(widths[i], '─');
+        std::cout << repeat("─", widths[i]);
         if (i < widths.size() - 1) std::cout << "┼";
     }
     std::cout << "┤" << std::endl;
@@ -76,12 +76,21 @@ void DisplayHelper::printTableRow(const std::vector<std::string>& values, const
 void DisplayHelper::printTableSeparator(const std::vector<int>& widths) {
     std::cout << "├";
     for (size_t i = 0; i < widths.size(); ++i) {
-        std::cout << std::string(widths[i], '─');
+        std::cout << repeat("─", widths[i]);
         if (i < widths.size() - 1) std::cout << "┼";
     }
     std::cout << "┤" << std::endl;
 }
 
+void DisplayHelper::printTableFooter(const std::vector<int>& widths) {
+    std::cout << "└";
+    for (size_t i = 0; i < widths.size(); ++i) {
+        std::cout << repeat("─", widths[i]);
+        if (i < widths.size() - 1) std::cout << "┴";
+    }
+    std::cout << "┘" << std::endl;
+}
+
 void DisplayHelper::printMessage(const std::string& message, bool isError) {
     if (isError) {
         setColor(COLOR_RED);
@@ -110,15 +119,16 @@ void DisplayHelper::printInfo(const std::string& message) {
     resetColor();
 }
 
-std::string DisplayHelper::formatAmount(double amount) {
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2) << amount;
-    return "¥" + oss.str();
+std::string DisplayHelper::formatAmount(Money amount) {
+    std::string text = "¥";
+    amount.appendTo(text);
+    return text;
 }
 
-std::string DisplayHelper::formatDate(const std::string& date) {
-    if (date.length() != 10) return date;
-    return date.substr(0, 4) + "年" + date.substr(5, 2) + "月" + date.substr(8, 2) + "日";
+std::string DisplayHelper::formatDate(Date date) {
+    if (date.isEmpty()) return "";
+    std::string text = date.toString();
+    return text.substr(0, 4) + "年" + text.substr(5, 2) + "月" + text.substr(8, 2) + "日";
 }
 
 std::string DisplayHelper::formatPercentage(double percentage) {
@@ -145,6 +155,14 @@ std::string DisplayHelper::center(const std::string& str, int width) {
     return std::string(leftPad, ' ') + str + std::string(rightPad, ' ');
 }
 
+std::string DisplayHelper::repeat(const std::string& unit, int count) {
+    std::string result;
+    if (count <= 0) return result;
+    result.reserve(unit.size() * static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) result += unit;
+    return result;
+}
+
 void DisplayHelper::setColor(int color) {
 #ifdef _WIN32
     HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
@@ -1,139 +1,110 @@
 #include "ExpenseRecord.h"
-#include <sstream>
+#include "CsvReader.h"
 #include <iomanip>
-#include <cmath>
 #include <vector>
 #include <string>
+#include <cstdio>
+#include <algorithm>
 
 // 默认构造函数
-ExpenseRecord::ExpenseRecord() : Record(), payee("") {
+ExpenseRecord::ExpenseRecord() : Record(), payee(StringDictionary::parties().getEmptyId()) {
 }
 
 // 带参数构造函数
-ExpenseRecord::ExpenseRecord(int id, const std::string& date, double amount,
+ExpenseRecord::ExpenseRecord(int id, Date date, Money amount,
                              const std::string& category, const std::string& payee,
                              const std::string& description)
-    : Record(id, date, amount, category, description), payee(payee) {
+    : Record(id, date, amount, category, description), payee(StringDictionary::parties().intern(payee)) {
 }
 
 // Getter
-std::string ExpenseRecord::getPayee() const {
+const std::string& ExpenseRecord::getPayee() const {
+    return StringDictionary::parties().text(payee);
+}
+
+uint32_t ExpenseRecord::getPayeeId() const {
     return payee;
 }
 
 // Setter
 void ExpenseRecord::setPayee(const std::string& payee) {
-    this->payee = payee;
-}
-
-// CSV字段转义辅助函数
-static std::string escapeCSVField(const std::string& field) {
-    bool needsQuotes = false;
-    std::string result;
-    
-    for (char c : field) {
-        if (c == '"') {
-            result += "\"\"";
-            needsQuotes = true;
-        } else if (c == ',' || c == '\n' || c == '\r') {
-            result += c;
-            needsQuotes = true;
-        } else {
-            result += c;
-        }
-    }
-    
-    if (needsQuotes) {
-        return "\"" + result + "\"";
-    }
-    return result;
-}
-
-// CSV字段反转义辅助函数
-static std::string unescapeCSVField(const std::string& field) {
-    if (field.empty()) return field;
-    
-    std::string result = field;
-    
-    // 去除首尾引号
-    if (result.length() >= 2 && result.front() == '"' && result.back() == '"') {
-        result = result.substr(1, result.length() - 2);
-    }
-    
-    // 处理双引号转义
-    std::string unescaped;
-    for (size_t i = 0; i < result.length(); ++i) {
-        if (result[i] == '"' && i + 1 < result.length() && result[i + 1] == '"') {
-            unescaped += '"';
-            ++i;
-        } else {
-            unescaped += result[i];
-        }
-    }
-    
-    return unescaped;
+    this->payee = StringDictionary::parties().intern(payee);
 }
 
-// 分割CSV行
-static std::vector<std::string> splitCSVLine(const std::string& line) {
-    std::vector<std::string> fields;
-    std::string field;
-    bool inQuotes = false;
-    
-    for (size_t i = 0; i < line.length(); ++i) {
-        char c = line[i];
-        
-        if (c == '"') {
-            if (inQuotes && i + 1 < line.length() && line[i + 1] == '"') {
-                field += '"';
-                ++i;
-            } else {
-                inQuotes = !inQuotes;
-                field += c;
-            }
-        } else if (c == ',' && !inQuotes) {
-            fields.push_back(field);
-            field.clear();
-        } else {
-            field += c;
-        }
-    }
-    fields.push_back(field);
-    
-    return fields;
+void ExpenseRecord::setPayeeId(uint32_t payeeId) {
+    this->payee = payeeId;
 }
 
 // 序列化为CSV格式
 std::string ExpenseRecord::toCSV() const {
-    std::ostringstream oss;
-    oss << id << ","
-        << escapeCSVField(date) << ","
-        << std::fixed << std::setprecision(2) << amount << ","
-        << escapeCSVField(category) << ","
-        << escapeCSVField(payee) << ","
-        << escapeCSVField(description);
-    return oss.str();
+    std::string line;
+    appendCSV(line);
+    return line;
+}
+
+void ExpenseRecord::appendCSV(std::string& out) const {
+    char number[64];
+    std::snprintf(number, sizeof(number), "%d,", id);
+    out += number;
+    date.appendTo(out);
+    out += ',';
+    amount.appendTo(out);
+    out += ',';
+    CsvWriter::appendField(out, getCategory());
+    out += ',';
+    CsvWriter::appendField(out, getPayee());
+    out += ',';
+    CsvWriter::appendField(out, description);
 }
 
 // 从CSV格式反序列化
 bool ExpenseRecord::fromCSV(const std::string& line) {
-    std::vector<std::string> fields = splitCSVLine(line);
-    
-    if (fields.size() < 6) {
-        return false;
+    CsvReader reader(line.data(), line.data() + line.size());
+    CsvField fields[CsvReader::MAX_FIELDS];
+    size_t count = 0;
+    return reader.next(fields, count) && fromFields(fields, count) == ParseStatus::Ok;
+}
+
+// 从已切分的CSV字段构建
+ParseStatus ExpenseRecord::fromFields(const CsvField* fields, size_t count, size_t* failedColumn) {
+    if (count < 6) {
+        if (failedColumn) *failedColumn = count;
+        return ParseStatus::MissingFields;
+    }
+    // 字段过多时可能是未加引号的千分位金额，合并后再解析
+    CsvField joined[CsvReader::MAX_FIELDS];
+    if (count > 6 && count <= CsvReader::MAX_FIELDS) {
+        std::copy(fields, fields + count, joined);
+        CsvReader::joinGroupedNumber(joined, count, 2, 6);
+        fields = joined;
+    }
+    ParseStatus status = fields[0].parseInt(id);
+    if (status != ParseStatus::Ok) {
+        if (failedColumn) *failedColumn = 0;
+        return status;
+    }
+    status = fields[1].parseDate(date);
+    if (status != ParseStatus::Ok) {
+        if (failedColumn) *failedColumn = 1;
+        return status;
+    }
+    status = fields[2].parseAmount(amount);
+    if (status != ParseStatus::Ok) {
+        if (failedColumn) *failedColumn = 2;
+        return status;
+    }
+    status = fields[3].intern(StringDictionary::categories(), category);
+    if (status != ParseStatus::Ok) {
+        if (failedColumn) *failedColumn = 3;
+        return status;
     }
-    
-    try {
-        id = std::stoi(fields[0]);
-        date = unescapeCSVField(fields[1]);
-        amount = std::stod(fields[2]);
-        category = unescapeCSVField(fields[3]);
-        payee = unescapeCSVField(fields[4]);
-        description = unescapeCSVField(fields[5]);
-        return true;
-    } catch (...) {
-        return false;
+    status = fields[4].intern(StringDictionary::parties(), payee);
+    if (status != ParseStatus::Ok) {
+        if (failedColumn) *failedColumn = 4;
+        return status;
     }
+    fields[5].assignTo(description);
+    return ParseStatus::Ok;
 }
 
 // 显示记录
@@ -142,11 +113,11 @@ void ExpenseRecord::display() const {
     std::cout << "│           支出记录详情                 │" << std::endl;
     std::cout << "├────────────────────────────────────────┤" << std::endl;
     std::cout << "│ ID:       " << std::setw(28) << std::left << id << "│" << std::endl;
-    std::cout << "│ 日期:     " << std::setw(28) << std::left << date << "│" << std::endl;
+    std::cout << "│ 日期:     " << std::setw(28) << std::left << date.toString() << "│" << std::endl;
     std::cout << "│ 金额:     " << std::setw(28) << std::left 
-              << std::fixed << std::setprecision(2) << amount << "│" << std::endl;
-    std::cout << "│ 分类:     " << std::setw(28) << std::left << category << "│" << std::endl;
-    std::cout << "│ 支付对象: " << std::setw(28) << std::left << payee << "│" << std::endl;
+              << amount.toString() << "│" << std::endl;
+    std::cout << "│ 分类:     " << std::setw(28) << std::left << getCategory() << "│" << std::endl;
+    std::cout << "│ 支付对象: " << std::setw(28) << std::left << getPayee() << "│" << std::endl;
     std::cout << "│ 描述:     " << std::setw(28) << std::left << description << "│" << std::endl;
     std::cout << "└────────────────────────────────────────┘" << std::endl;
 }
@@ -160,7 +131,7 @@ std::string ExpenseRecord::getTypeName() const {
 bool ExpenseRecord::operator==(const ExpenseRecord& other) const {
     return id == other.id &&
            date == other.date &&
-           std::abs(amount - other.amount) < 0.01 &&
+           amount == other.amount &&
            category == other.category &&
            payee == other.payee &&
            description == other.description;
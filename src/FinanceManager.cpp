@@ -1,150 +1,312 @@
 #include "FinanceManager.h"
 #include <algorithm>
+#include <future>
 
 FinanceManager::FinanceManager() : storage() {}
-FinanceManager::FinanceManager(const std::string& incomeFile, const std::string& expenseFile) : storage(incomeFile, expenseFile) {}
-FinanceManager::~FinanceManager() { saveAll(); }
+FinanceManager::FinanceManager(const std::string& incomeFile, const std::string& expenseFile, const StorageOptions& options)
+    : storage(incomeFile, expenseFile, options) {}
+// 每次修改都已写入日志，析构时只需等待后台压缩结束
+FinanceManager::~FinanceManager() {
+    storage.flushJournals();
+    storage.waitForCompaction();
+}
 
 bool FinanceManager::initialize() {
-    incomeRecords = storage.loadIncomeRecords();
-    expenseRecords = storage.loadExpenseRecords();
+    // 先清理上次崩溃留下的半成品，保证后面读到的都是完整文件
+    storage.recoverInterruptedWrites();
+
+    // 快速路径：二进制快照与CSV一致时直接批量读取
+    std::vector<IncomeRecord> incomeRecords;
+    std::vector<ExpenseRecord> expenseRecords;
+    if (!storage.loadSnapshot(incomeRecords, expenseRecords)) {
+        if (storage.getLoadThreads() > 1) {
+            // 收入和支出两个文件同时加载
+            auto incomeFuture = std::async(std::launch::async, [this]() { return storage.loadIncomeRecords(); });
+            expenseRecords = storage.loadExpenseRecords();
+            incomeRecords = incomeFuture.get();
+        } else {
+            incomeRecords = storage.loadIncomeRecords();
+            expenseRecords = storage.loadExpenseRecords();
+        }
+        // 快照缺失或已过期，按当前数据重新生成（日志重放是幂等的，包含日志内容也无妨）
+        storage.saveSnapshot(incomeRecords, expenseRecords);
+    }
+    // 转成列式存储后，加载用的记录对象即可释放
+    incomeLedger.assign(incomeRecords);
+    expenseLedger.assign(expenseRecords);
+    // 上次压缩中途退出，重放完成后立即落盘一次
+    if (storage.hasPendingCompaction()) return saveAll();
     return true;
 }
 
 bool FinanceManager::saveAll() {
-    return storage.saveIncomeRecords(incomeRecords) && storage.saveExpenseRecords(expenseRecords);
+    return storage.checkpoint(incomeLedger.getColumns().toRecords(), expenseLedger.getColumns().toRecords());
+}
+
+bool FinanceManager::flush() {
+    return storage.flushJournals();
+}
+
+std::vector<LoadIssue> FinanceManager::getLoadIssues() const {
+    return storage.getLoadIssues();
+}
+
+size_t FinanceManager::getSkippedRowCount() const {
+    return storage.getSkippedRowCount();
 }
 
-IncomeRecord* FinanceManager::findIncomeById(int id) {
-    for (auto& r : incomeRecords) if (r.getId() == id) return &r;
-    return nullptr;
+bool FinanceManager::journalIncome(JournalOp op, const IncomeRecord& record) {
+    if (!storage.appendIncomeJournal(op, record)) return false;
+    if (storage.needsCompaction()) storage.compactInBackground(incomeLedger.getColumns(), expenseLedger.getColumns());
+    return true;
 }
 
-const IncomeRecord* FinanceManager::findIncomeById(int id) const {
-    for (const auto& r : incomeRecords) if (r.getId() == id) return &r;
-    return nullptr;
+bool FinanceManager::journalExpense(JournalOp op, const ExpenseRecord& record) {
+    if (!storage.appendExpenseJournal(op, record)) return false;
+    if (storage.needsCompaction()) storage.compactInBackground(incomeLedger.getColumns(), expenseLedger.getColumns());
+    return true;
 }
 
-ExpenseRecord* FinanceManager::findExpenseById(int id) {
-    for (auto& r : expenseRecords) if (r.getId() == id) return &r;
-    return nullptr;
+// 日期范围查询：两次二分查找定位区间，视图之后按日期顺序连续遍历
+template <typename T>
+static RecordView<T> viewByDateRange(const RecordColumns<T>& columns, const DateIndex& index, Date startDate, Date endDate) {
+    return RecordView<T>(columns, index, index.lowerBound(startDate.getPacked()), index.upperBound(endDate.getPacked()));
 }
 
-const ExpenseRecord* FinanceManager::findExpenseById(int id) const {
-    for (const auto& r : expenseRecords) if (r.getId() == id) return &r;
-    return nullptr;
+// 分类的倒排表；分类只查不驻留，字典中没有或从未使用过的分类返回 nullptr
+template <typename T>
+static const DateIndex* categoryIndexOf(const RecordLedger<T>& ledger, const std::string& category) {
+    uint32_t categoryId = StringDictionary::categories().find(category);
+    if (categoryId == StringDictionary::NONE) return nullptr;
+    return ledger.getCategoryIndex(categoryId);
+}
+
+template <typename T>
+static RecordView<T> viewByCategory(const RecordLedger<T>& ledger, const std::string& category) {
+    const DateIndex* index = categoryIndexOf(ledger, category);
+    if (!index) return RecordView<T>();
+    return RecordView<T>(ledger.getColumns(), *index, index->begin(), index->end());
+}
+
+template <typename T>
+static RecordView<T> viewByCategoryAndDateRange(const RecordLedger<T>& ledger, const std::string& category,
+                                                Date startDate, Date endDate) {
+    const DateIndex* index = categoryIndexOf(ledger, category);
+    if (!index) return RecordView<T>();
+    return viewByDateRange(ledger.getColumns(), *index, startDate, endDate);
+}
+
+template <typename T>
+static RecordView<T> viewAll(const RecordLedger<T>& ledger) {
+    const DateIndex& index = ledger.getDateIndex();
+    return RecordView<T>(ledger.getColumns(), index, index.begin(), index.end());
 }
 
 bool FinanceManager::addIncome(const IncomeRecord& record) {
-    incomeRecords.push_back(record);
-    return saveAll();
+    incomeLedger.add(record);
+    return journalIncome(JournalOp::Upsert, record);
 }
 
 bool FinanceManager::deleteIncome(int id) {
-    auto it = std::find_if(incomeRecords.begin(), incomeRecords.end(), [id](const IncomeRecord& r) { return r.getId() == id; });
-    if (it != incomeRecords.end()) { incomeRecords.erase(it); return saveAll(); }
-    return false;
+    IncomeRecord removed;
+    if (!incomeLedger.remove(id, removed)) return false;
+    return journalIncome(JournalOp::Delete, removed);
 }
 
 bool FinanceManager::modifyIncome(int id, const IncomeRecord& newData) {
-    IncomeRecord* record = findIncomeById(id);
-    if (!record) return false;
-    if (!newData.getDate().empty()) record->setDate(newData.getDate());
-    if (newData.getAmount() > 0) record->setAmount(newData.getAmount());
-    if (!newData.getCategory().empty()) record->setCategory(newData.getCategory());
-    if (!newData.getSource().empty()) record->setSource(newData.getSource());
-    if (!newData.getDescription().empty()) record->setDescription(newData.getDescription());
-    return saveAll();
-}
-
-IncomeRecord* FinanceManager::getIncomeById(int id) { return findIncomeById(id); }
-const IncomeRecord* FinanceManager::getIncomeById(int id) const { return findIncomeById(id); }
-
-std::vector<IncomeRecord> FinanceManager::queryIncomeByDateRange(const std::string& startDate, const std::string& endDate) const {
-    std::vector<IncomeRecord> result;
-    for (const auto& r : incomeRecords) {
-        if (r.getDate() >= startDate && r.getDate() <= endDate) result.push_back(r);
+    size_t slot;
+    if (!incomeLedger.findSlot(id, slot)) return false;
+    IncomeRecord record = incomeLedger.getColumns().get(slot);
+    // 日期变化时先记录原记录的删除，按月分区布局据此同时重写原月份；
+    // 两条日志之间不能触发压缩，所以直接写日志
+    if (!newData.getDate().isEmpty() && newData.getDate() != record.getDate() &&
+        !storage.appendIncomeJournal(JournalOp::Delete, record)) {
+        return false;
     }
-    std::sort(result.begin(), result.end(), [](const IncomeRecord& a, const IncomeRecord& b) { return a.getDate() < b.getDate(); });
-    return result;
+    if (!newData.getDate().isEmpty()) record.setDate(newData.getDate());
+    if (newData.getAmount().isPositive()) record.setAmount(newData.getAmount());
+    if (!newData.getCategory().empty()) record.setCategoryId(newData.getCategoryId());
+    if (!newData.getSource().empty()) record.setSourceId(newData.getSourceId());
+    if (!newData.getDescription().empty()) record.setDescription(newData.getDescription());
+    incomeLedger.update(slot, record);
+    return journalIncome(JournalOp::Upsert, record);
+}
+
+bool FinanceManager::getIncomeById(int id, IncomeRecord& record) const {
+    return incomeLedger.get(id, record);
+}
+
+RecordView<IncomeRecord> FinanceManager::viewIncome() const {
+    return viewAll(incomeLedger);
+}
+
+RecordView<IncomeRecord> FinanceManager::viewIncomeByDateRange(Date startDate, Date endDate) const {
+    return viewByDateRange(incomeLedger.getColumns(), incomeLedger.getDateIndex(), startDate, endDate);
+}
+
+RecordView<IncomeRecord> FinanceManager::viewIncomeByCategory(const std::string& category) const {
+    return viewByCategory(incomeLedger, category);
+}
+
+RecordView<IncomeRecord> FinanceManager::viewIncomeByCategoryAndDateRange(const std::string& category,
+                                                                          Date startDate, Date endDate) const {
+    return viewByCategoryAndDateRange(incomeLedger, category, startDate, endDate);
+}
+
+RecordView<IncomeRecord> FinanceManager::viewIncomeByKeyword(const std::string& keyword) const {
+    return RecordView<IncomeRecord>(incomeLedger.getColumns(), incomeLedger.search(keyword));
+}
+
+std::vector<IncomeRecord> FinanceManager::queryIncomeByDateRange(Date startDate, Date endDate,
+                                                                 size_t offset, size_t limit) const {
+    return viewIncomeByDateRange(startDate, endDate).page(offset, limit).toRecords();
+}
+
+std::vector<IncomeRecord> FinanceManager::queryIncomeByCategory(const std::string& category,
+                                                                size_t offset, size_t limit) const {
+    return viewIncomeByCategory(category).page(offset, limit).toRecords();
+}
+
+std::vector<IncomeRecord> FinanceManager::queryIncomeByCategoryAndDateRange(const std::string& category,
+                                                                            Date startDate, Date endDate, size_t offset, size_t limit) const {
+    return viewIncomeByCategoryAndDateRange(category, startDate, endDate).page(offset, limit).toRecords();
 }
 
-std::vector<IncomeRecord> FinanceManager::queryIncomeByCategory(const std::string& category) const {
-    std::vector<IncomeRecord> result;
-    for (const auto& r : incomeRecords) if (r.getCategory() == category) result.push_back(r);
-    std::sort(result.begin(), result.end(), [](const IncomeRecord& a, const IncomeRecord& b) { return a.getDate() < b.getDate(); });
-    return result;
+std::vector<IncomeRecord> FinanceManager::searchIncome(const std::string& keyword, size_t offset, size_t limit) const {
+    return viewIncomeByKeyword(keyword).page(offset, limit).toRecords();
 }
 
-std::vector<IncomeRecord> FinanceManager::getAllIncome() const {
-    std::vector<IncomeRecord> result = incomeRecords;
-    std::sort(result.begin(), result.end(), [](const IncomeRecord& a, const IncomeRecord& b) { return a.getDate() < b.getDate(); });
-    return result;
+std::vector<IncomeRecord> FinanceManager::getAllIncome(size_t offset, size_t limit) const {
+    return viewIncome().page(offset, limit).toRecords();
 }
 
-int FinanceManager::getIncomeCount() const { return static_cast<int>(incomeRecords.size()); }
+int FinanceManager::getIncomeCount() const { return static_cast<int>(incomeLedger.size()); }
+
+const RecordColumns<IncomeRecord>& FinanceManager::getIncomeColumns() const { return incomeLedger.getColumns(); }
+
+const LedgerTotals& FinanceManager::getIncomeTotals() const { return incomeLedger.getTotals(); }
 
 bool FinanceManager::addExpense(const ExpenseRecord& record) {
-    expenseRecords.push_back(record);
-    return saveAll();
+    expenseLedger.add(record);
+    return journalExpense(JournalOp::Upsert, record);
 }
 
 bool FinanceManager::deleteExpense(int id) {
-    auto it = std::find_if(expenseRecords.begin(), expenseRecords.end(), [id](const ExpenseRecord& r) { return r.getId() == id; });
-    if (it != expenseRecords.end()) { expenseRecords.erase(it); return saveAll(); }
-    return false;
+    ExpenseRecord removed;
+    if (!expenseLedger.remove(id, removed)) return false;
+    return journalExpense(JournalOp::Delete, removed);
 }
 
 bool FinanceManager::modifyExpense(int id, const ExpenseRecord& newData) {
-    ExpenseRecord* record = findExpenseById(id);
-    if (!record) return false;
-    if (!newData.getDate().empty()) record->setDate(newData.getDate());
-    if (newData.getAmount() > 0) record->setAmount(newData.getAmount());
-    if (!newData.getCategory().empty()) record->setCategory(newData.getCategory());
-    if (!newData.getPayee().empty()) record->setPayee(newData.getPayee());
-    if (!newData.getDescription().empty()) record->setDescription(newData.getDescription());
-    return saveAll();
-}
-
-ExpenseRecord* FinanceManager::getExpenseById(int id) { return findExpenseById(id); }
-const ExpenseRecord* FinanceManager::getExpenseById(int id) const { return findExpenseById(id); }
-
-std::vector<ExpenseRecord> FinanceManager::queryExpenseByDateRange(const std::string& startDate, const std::string& endDate) const {
-    std::vector<ExpenseRecord> result;
-    for (const auto& r : expenseRecords) {
-        if (r.getDate() >= startDate && r.getDate() <= endDate) result.push_back(r);
+    size_t slot;
+    if (!expenseLedger.findSlot(id, slot)) return false;
+    ExpenseRecord record = expenseLedger.getColumns().get(slot);
+    // 日期变化时先记录原记录的删除，按月分区布局据此同时重写原月份；
+    // 两条日志之间不能触发压缩，所以直接写日志
+    if (!newData.getDate().isEmpty() && newData.getDate() != record.getDate() &&
+        !storage.appendExpenseJournal(JournalOp::Delete, record)) {
+        return false;
     }
-    std::sort(result.begin(), result.end(), [](const ExpenseRecord& a, const ExpenseRecord& b) { return a.getDate() < b.getDate(); });
-    return result;
+    if (!newData.getDate().isEmpty()) record.setDate(newData.getDate());
+    if (newData.getAmount().isPositive()) record.setAmount(newData.getAmount());
+    if (!newData.getCategory().empty()) record.setCategoryId(newData.getCategoryId());
+    if (!newData.getPayee().empty()) record.setPayeeId(newData.getPayeeId());
+    if (!newData.getDescription().empty()) record.setDescription(newData.getDescription());
+    expenseLedger.update(slot, record);
+    return journalExpense(JournalOp::Upsert, record);
+}
+
+bool FinanceManager::getExpenseById(int id, ExpenseRecord& record) const {
+    return expenseLedger.get(id, record);
+}
+
+RecordView<ExpenseRecord> FinanceManager::viewExpense() const {
+    return viewAll(expenseLedger);
+}
+
+RecordView<ExpenseRecord> FinanceManager::viewExpenseByDateRange(Date startDate, Date endDate) const {
+    return viewByDateRange(expenseLedger.getColumns(), expenseLedger.getDateIndex(), startDate, endDate);
+}
+
+RecordView<ExpenseRecord> FinanceManager::viewExpenseByCategory(const std::string& category) const {
+    return viewByCategory(expenseLedger, category);
+}
+
+RecordView<ExpenseRecord> FinanceManager::viewExpenseByCategoryAndDateRange(const std::string& category,
+                                                                            Date startDate, Date endDate) const {
+    return viewByCategoryAndDateRange(expenseLedger, category, startDate, endDate);
+}
+
+RecordView<ExpenseRecord> FinanceManager::viewExpenseByKeyword(const std::string& keyword) const {
+    return RecordView<ExpenseRecord>(expenseLedger.getColumns(), expenseLedger.search(keyword));
+}
+
+std::vector<ExpenseRecord> FinanceManager::queryExpenseByDateRange(Date startDate, Date endDate,
+                                                                   size_t offset, size_t limit) const {
+    return viewExpenseByDateRange(startDate, endDate).page(offset, limit).toRecords();
+}
+
+std::vector<ExpenseRecord> FinanceManager::queryExpenseByCategory(const std::string& category,
+                                                                  size_t offset, size_t limit) const {
+    return viewExpenseByCategory(category).page(offset, limit).toRecords();
 }
 
-std::vector<ExpenseRecord> FinanceManager::queryExpenseByCategory(const std::string& category) const {
-    std::vector<ExpenseRecord> result;
-    for (const auto& r : expenseRecords) if (r.getCategory() == category) result.push_back(r);
-    std::sort(result.begin(), result.end(), [](const ExpenseRecord& a, const ExpenseRecord& b) { return a.getDate() < b.getDate(); });
-    return result;
+std::vector<ExpenseRecord> FinanceManager::queryExpenseByCategoryAndDateRange(const std::string& category,
+                                                                              Date startDate, Date endDate, size_t offset, size_t limit) const {
+    return viewExpenseByCategoryAndDateRange(category, startDate, endDate).page(offset, limit).toRecords();
 }
 
-std::vector<ExpenseRecord> FinanceManager::getAllExpense() const {
-    std::vector<ExpenseRecord> result = expenseRecords;
-    std::sort(result.begin(), result.end(), [](const ExpenseRecord& a, const ExpenseRecord& b) { return a.getDate() < b.getDate(); });
-    return result;
+std::vector<ExpenseRecord> FinanceManager::searchExpense(const std::string& keyword, size_t offset, size_t limit) const {
+    return viewExpenseByKeyword(keyword).page(offset, limit).toRecords();
 }
 
-int FinanceManager::getExpenseCount() const { return static_cast<int>(expenseRecords.size()); }
+std::vector<ExpenseRecord> FinanceManager::getAllExpense(size_t offset, size_t limit) const {
+    return viewExpense().page(offset, limit).toRecords();
+}
+
+int FinanceManager::getExpenseCount() const { return static_cast<int>(expenseLedger.size()); }
+
+const RecordColumns<ExpenseRecord>& FinanceManager::getExpenseColumns() const { return expenseLedger.getColumns(); }
+
+const LedgerTotals& FinanceManager::getExpenseTotals() const { return expenseLedger.getTotals(); }
+
+Money FinanceManager::getTotalIncome() const {
+    return incomeLedger.getTotals().getTotal();
+}
+
+Money FinanceManager::getTotalExpense() const {
+    return expenseLedger.getTotals().getTotal();
+}
+
+Money FinanceManager::getNetBalance() const { return getTotalIncome() - getTotalExpense(); }
+
+// 某个分类在区间内的合计；分类只查不驻留，没有出现过的分类合计为0
+static Money categoryTotalBetween(const LedgerTotals& totals, const std::string& category, Date startDate, Date endDate) {
+    uint32_t categoryId = StringDictionary::categories().find(category);
+    if (categoryId == StringDictionary::NONE) return Money();
+    const DailyTotals* daily = totals.getDailyByCategory(categoryId);
+    return daily ? daily->totalBetween(startDate, endDate) : Money();
+}
+
+Money FinanceManager::getIncomeBetween(Date startDate, Date endDate) const {
+    return incomeLedger.getTotals().getDaily().totalBetween(startDate, endDate);
+}
+
+Money FinanceManager::getExpenseBetween(Date startDate, Date endDate) const {
+    return expenseLedger.getTotals().getDaily().totalBetween(startDate, endDate);
+}
+
+Money FinanceManager::getIncomeByCategoryBetween(const std::string& category, Date startDate, Date endDate) const {
+    return categoryTotalBetween(incomeLedger.getTotals(), category, startDate, endDate);
+}
 
-double FinanceManager::getTotalIncome() const {
-    double total = 0.0;
-    for (const auto& r : incomeRecords) total += r.getAmount();
-    return total;
+Money FinanceManager::getExpenseByCategoryBetween(const std::string& category, Date startDate, Date endDate) const {
+    return categoryTotalBetween(expenseLedger.getTotals(), category, startDate, endDate);
 }
 
-double FinanceManager::getTotalExpense() const {
-    double total = 0.0;
-    for (const auto& r : expenseRecords) total += r.getAmount();
-    return total;
+Money FinanceManager::getBalanceAsOf(Date date) const {
+    return incomeLedger.getTotals().getDaily().totalThrough(date) - expenseLedger.getTotals().getDaily().totalThrough(date);
 }
 
-double FinanceManager::getNetBalance() const { return getTotalIncome() - getTotalExpense(); }
 int FinanceManager::getNextIncomeId() { return storage.getNextIncomeId(); }
 int FinanceManager::getNextExpenseId() { return storage.getNextExpenseId(); }
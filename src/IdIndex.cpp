@@ -0,0 +1,88 @@
+#include "IdIndex.h"
+
+const uint32_t IdIndex::EMPTY;
+
+IdIndex::IdIndex() : used(0), shift(64) {}
+
+void IdIndex::clear() {
+    entries.clear();
+    used = 0;
+    shift = 64;
+}
+
+void IdIndex::reserve(size_t count) {
+    // 装载率不超过一半
+    size_t capacity = 16;
+    while (capacity < count * 2) capacity *= 2;
+    if (capacity > entries.size()) rehash(capacity);
+}
+
+// 乘法散列取高位，连续的ID也能均匀分布
+size_t IdIndex::home(int id) const {
+    return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(id)) * 0x9E3779B97F4A7C15ull) >> shift);
+}
+
+void IdIndex::set(int id, uint32_t slot) {
+    if ((used + 1) * 2 > entries.size()) rehash(entries.empty() ? 16 : entries.size() * 2);
+    size_t mask = entries.size() - 1;
+    for (size_t i = home(id);; i = (i + 1) & mask) {
+        Entry& entry = entries[i];
+        if (entry.slot == EMPTY) {
+            entry.id = id;
+            entry.slot = slot;
+            ++used;
+            return;
+        }
+        if (entry.id == id) {
+            entry.slot = slot;
+            return;
+        }
+    }
+}
+
+bool IdIndex::find(int id, uint32_t& slot) const {
+    if (entries.empty()) return false;
+    size_t mask = entries.size() - 1;
+    for (size_t i = home(id);; i = (i + 1) & mask) {
+        const Entry& entry = entries[i];
+        if (entry.slot == EMPTY) return false;
+        if (entry.id == id) {
+            slot = entry.slot;
+            return true;
+        }
+    }
+}
+
+bool IdIndex::erase(int id) {
+    if (entries.empty()) return false;
+    size_t mask = entries.size() - 1;
+    size_t hole = home(id);
+    while (entries[hole].slot != EMPTY && entries[hole].id != id) hole = (hole + 1) & mask;
+    if (entries[hole].slot == EMPTY) return false;
+
+    // 把探测链上原本越过空洞的条目前移，保证后续查找不会提前遇到空位
+    for (size_t i = (hole + 1) & mask; entries[i].slot != EMPTY; i = (i + 1) & mask) {
+        size_t want = home(entries[i].id);
+        bool between = hole <= i ? (hole < want && want <= i) : (hole < want || want <= i);
+        if (!between) {
+            entries[hole] = entries[i];
+            hole = i;
+        }
+    }
+    entries[hole].slot = EMPTY;
+    --used;
+    return true;
+}
+
+void IdIndex::rehash(size_t capacity) {
+    std::vector<Entry> old;
+    old.swap(entries);
+    Entry empty = {0, EMPTY};
+    entries.assign(capacity, empty);
+    shift = 64;
+    for (size_t c = capacity; c > 1; c >>= 1) --shift;
+    used = 0;
+    for (const auto& entry : old) {
+        if (entry.slot != EMPTY) set(entry.id, entry.slot);
+    }
+}
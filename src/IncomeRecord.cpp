@@ -1,139 +1,110 @@
 #include "IncomeRecord.h"
-#include <sstream>
+#include "CsvReader.h"
 #include <iomanip>
-#include <cmath>
 #include <vector>
 #include <string>
+#include <cstdio>
+#include <algorithm>
 
 // 默认构造函数
-IncomeRecord::IncomeRecord() : Record(), source("") {
+IncomeRecord::IncomeRecord() : Record(), source(StringDictionary::parties().getEmptyId()) {
 }
 
 // 带参数构造函数
-IncomeRecord::IncomeRecord(int id, const std::string& date, double amount,
+IncomeRecord::IncomeRecord(int id, Date date, Money amount,
                            const std::string& category, const std::string& source,
                            const std::string& description)
-    : Record(id, date, amount, category, description), source(source) {
+    : Record(id, date, amount, category, description), source(StringDictionary::parties().intern(source)) {
 }
 
 // Getter
-std::string IncomeRecord::getSource() const {
+const std::string& IncomeRecord::getSource() const {
+    return StringDictionary::parties().text(source);
+}
+
+uint32_t IncomeRecord::getSourceId() const {
     return source;
 }
 
 // Setter
 void IncomeRecord::setSource(const std::string& source) {
-    this->source = source;
-}
-
-// CSV字段转义辅助函数
-static std::string escapeCSVField(const std::string& field) {
-    bool needsQuotes = false;
-    std::string result;
-    
-    for (char c : field) {
-        if (c == '"') {
-            result += "\"\"";
-            needsQuotes = true;
-        } else if (c == ',' || c == '\n' || c == '\r') {
-            result += c;
-            needsQuotes = true;
-        } else {
-            result += c;
-        }
-    }
-    
-    if (needsQuotes) {
-        return "\"" + result + "\"";
-    }
-    return result;
-}
-
-// CSV字段反转义辅助函数
-static std::string unescapeCSVField(const std::string& field) {
-    if (field.empty()) return field;
-    
-    std::string result = field;
-    
-    // 去除首尾引号
-    if (result.length() >= 2 && result.front() == '"' && result.back() == '"') {
-        result = result.substr(1, result.length() - 2);
-    }
-    
-    // 处理双引号转义
-    std::string unescaped;
-    for (size_t i = 0; i < result.length(); ++i) {
-        if (result[i] == '"' && i + 1 < result.length() && result[i + 1] == '"') {
-            unescaped += '"';
-            ++i;
-        } else {
-            unescaped += result[i];
-        }
-    }
-    
-    return unescaped;
+    this->source = StringDictionary::parties().intern(source);
 }
 
-// 分割CSV行
-static std::vector<std::string> splitCSVLine(const std::string& line) {
-    std::vector<std::string> fields;
-    std::string field;
-    bool inQuotes = false;
-    
-    for (size_t i = 0; i < line.length(); ++i) {
-        char c = line[i];
-        
-        if (c == '"') {
-            if (inQuotes && i + 1 < line.length() && line[i + 1] == '"') {
-                field += '"';
-                ++i;
-            } else {
-                inQuotes = !inQuotes;
-                field += c;
-            }
-        } else if (c == ',' && !inQuotes) {
-            fields.push_back(field);
-            field.clear();
-        } else {
-            field += c;
-        }
-    }
-    fields.push_back(field);
-    
-    return fields;
+void IncomeRecord::setSourceId(uint32_t sourceId) {
+    this->source = sourceId;
 }
 
 // 序列化为CSV格式
 std::string IncomeRecord::toCSV() const {
-    std::ostringstream oss;
-    oss << id << ","
-        << escapeCSVField(date) << ","
-        << std::fixed << std::setprecision(2) << amount << ","
-        << escapeCSVField(category) << ","
-        << escapeCSVField(source) << ","
-        << escapeCSVField(description);
-    return oss.str();
+    std::string line;
+    appendCSV(line);
+    return line;
+}
+
+void IncomeRecord::appendCSV(std::string& out) const {
+    char number[64];
+    std::snprintf(number, sizeof(number), "%d,", id);
+    out += number;
+    date.appendTo(out);
+    out += ',';
+    amount.appendTo(out);
+    out += ',';
+    CsvWriter::appendField(out, getCategory());
+    out += ',';
+    CsvWriter::appendField(out, getSource());
+    out += ',';
+    CsvWriter::appendField(out, description);
 }
 
 // 从CSV格式反序列化
 bool IncomeRecord::fromCSV(const std::string& line) {
-    std::vector<std::string> fields = splitCSVLine(line);
-    
-    if (fields.size() < 6) {
-        return false;
+    CsvReader reader(line.data(), line.data() + line.size());
+    CsvField fields[CsvReader::MAX_FIELDS];
+    size_t count = 0;
+    return reader.next(fields, count) && fromFields(fields, count) == ParseStatus::Ok;
+}
+
+// 从已切分的CSV字段构建
+ParseStatus IncomeRecord::fromFields(const CsvField* fields, size_t count, size_t* failedColumn) {
+    if (count < 6) {
+        if (failedColumn) *failedColumn = count;
+        return ParseStatus::MissingFields;
+    }
+    // 字段过多时可能是未加引号的千分位金额，合并后再解析
+    CsvField joined[CsvReader::MAX_FIELDS];
+    if (count > 6 && count <= CsvReader::MAX_FIELDS) {
+        std::copy(fields, fields + count, joined);
+        CsvReader::joinGroupedNumber(joined, count, 2, 6);
+        fields = joined;
+    }
+    ParseStatus status = fields[0].parseInt(id);
+    if (status != ParseStatus::Ok) {
+        if (failedColumn) *failedColumn = 0;
+        return status;
+    }
+    status = fields[1].parseDate(date);
+    if (status != ParseStatus::Ok) {
+        if (failedColumn) *failedColumn = 1;
+        return status;
+    }
+    status = fields[2].parseAmount(amount);
+    if (status != ParseStatus::Ok) {
+        if (failedColumn) *failedColumn = 2;
+        return status;
+    }
+    status = fields[3].intern(StringDictionary::categories(), category);
+    if (status != ParseStatus::Ok) {
+        if (failedColumn) *failedColumn = 3;
+        return status;
     }
-    
-    try {
-        id = std::stoi(fields[0]);
-        date = unescapeCSVField(fields[1]);
-        amount = std::stod(fields[2]);
-        category = unescapeCSVField(fields[3]);
-        source = unescapeCSVField(fields[4]);
-        description = unescapeCSVField(fields[5]);
-        return true;
-    } catch (...) {
-        return false;
+    status = fields[4].intern(StringDictionary::parties(), source);
+    if (status != ParseStatus::Ok) {
+        if (failedColumn) *failedColumn = 4;
+        return status;
     }
+    fields[5].assignTo(description);
+    return ParseStatus::Ok;
 }
 
 // 显示记录
@@ -142,11 +113,11 @@ void IncomeRecord::display() const {
     std::cout << "│           收入记录详情                 │" << std::endl;
     std::cout << "├────────────────────────────────────────┤" << std::endl;
     std::cout << "│ ID:       " << std::setw(28) << std::left << id << "│" << std::endl;
-    std::cout << "│ 日期:     " << std::setw(28) << std::left << date << "│" << std::endl;
+    std::cout << "│ 日期:     " << std::setw(28) << std::left << date.toString() << "│" << std::endl;
     std::cout << "│ 金额:     " << std::setw(28) << std::left 
-              << std::fixed << std::setprecision(2) << amount << "│" << std::endl;
-    std::cout << "│ 分类:     " << std::setw(28) << std::left << category << "│" << std::endl;
-    std::cout << "│ 来源:     " << std::setw(28) << std::left << source << "│" << std::endl;
+              << amount.toString() << "│" << std::endl;
+    std::cout << "│ 分类:     " << std::setw(28) << std::left << getCategory() << "│" << std::endl;
+    std::cout << "│ 来源:     " << std::setw(28) << std::left << getSource() << "│" << std::endl;
     std::cout << "│ 描述:     " << std::setw(28) << std::left << description << "│" << std::endl;
     std::cout << "└────────────────────────────────────────┘" << std::endl;
 }
@@ -160,7 +131,7 @@ std::string IncomeRecord::getTypeName() const {
 bool IncomeRecord::operator==(const IncomeRecord& other) const {
     return id == other.id &&
            date == other.date &&
-           std::abs(amount - other.amount) < 0.01 &&
+           amount == other.amount &&
            category == other.category &&
            source == other.source &&
            description == other.description;
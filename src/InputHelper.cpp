@@ -1,4 +1,5 @@
 #include "InputHelper.h"
+#include "NumberParser.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -37,8 +38,8 @@ int InputHelper::getMenuChoice(int min, int max) {
     }
 }
 
-double InputHelper::getAmount(const std::string& prompt) {
-    double amount;
+Money InputHelper::getAmount(const std::string& prompt) {
+    Money amount;
     while (true) {
         std::cout << prompt;
         std::string input;
@@ -50,19 +51,18 @@ double InputHelper::getAmount(const std::string& prompt) {
             continue;
         }
         
-        try {
-            amount = std::stod(input);
-            if (isValidAmount(amount)) {
-                return amount;
-            }
-            std::cout << "金额必须大于0，请重新输入。" << std::endl;
-        } catch (...) {
+        if (Money::parse(input, amount) != ParseStatus::Ok) {
             std::cout << "输入无效，请重新输入。" << std::endl;
+            continue;
         }
+        if (isValidAmount(amount)) {
+            return amount;
+        }
+        std::cout << "金额必须大于0，请重新输入。" << std::endl;
     }
 }
 
-std::string InputHelper::getDate(const std::string& prompt) {
+Date InputHelper::getDate(const std::string& prompt) {
     while (true) {
         std::cout << prompt << " (格式: YYYY-MM-DD，直接回车使用今天): ";
         std::string input;
@@ -70,11 +70,12 @@ std::string InputHelper::getDate(const std::string& prompt) {
         input = trim(input);
         
         if (input.empty()) {
-            return getCurrentDate();
+            return Date::today();
         }
         
-        if (isValidDate(input)) {
-            return input;
+        Date date;
+        if (Date::parse(input, date) == ParseStatus::Ok) {
+            return date;
         }
         std::cout << "日期格式错误，请使用 YYYY-MM-DD 格式。" << std::endl;
     }
@@ -139,6 +140,25 @@ int InputHelper::getRecordId(const std::string& prompt) {
     }
 }
 
+int InputHelper::getCount(const std::string& prompt, int defaultValue) {
+    while (true) {
+        std::cout << prompt << " (直接回车使用 " << defaultValue << "): ";
+        std::string input;
+        std::getline(std::cin, input);
+        input = trim(input);
+        
+        if (input.empty()) {
+            return defaultValue;
+        }
+        
+        int count;
+        if (NumberParser::parseInt(input.data(), input.size(), count) == ParseStatus::Ok && count > 0) {
+            return count;
+        }
+        std::cout << "请输入大于0的整数。" << std::endl;
+    }
+}
+
 std::string InputHelper::getCategory(const std::string& prompt, const std::vector<std::string>& categories) {
     std::cout << prompt << std::endl << "可选分类：" << std::endl;
     
@@ -157,33 +177,13 @@ std::string InputHelper::getCategory(const std::string& prompt, const std::vecto
 }
 
 bool InputHelper::isValidDate(const std::string& date) {
-    if (date.length() != 10) return false;
-    if (date[4] != '-' || date[7] != '-') return false;
-    
-    for (int i = 0; i < 10; ++i) {
-        if (i == 4 || i == 7) continue;
-        if (!std::isdigit(date[i])) return false;
-    }
-    
-    try {
-        int year = std::stoi(date.substr(0, 4));
-        int month = std::stoi(date.substr(5, 2));
-        int day = std::stoi(date.substr(8, 2));
-        
-        if (year < 1900 || year > 2100) return false;
-        if (month < 1 || month > 12) return false;
-        
-        int maxDays = getDaysInMonth(year, month);
-        if (day < 1 || day > maxDays) return false;
-        
-        return true;
-    } catch (...) {
-        return false;
-    }
+    // 校验规则由 Date::parse 实现，加载CSV时使用同一套规则
+    Date parsed;
+    return date.length() == 10 && Date::parse(date, parsed) == ParseStatus::Ok;
 }
 
-bool InputHelper::isValidAmount(double amount) {
-    return amount > 0;
+bool InputHelper::isValidAmount(Money amount) {
+    return amount.isPositive();
 }
 
 bool InputHelper::isNumeric(const std::string& str) {
@@ -208,8 +208,8 @@ bool InputHelper::isNumeric(const std::string& str) {
     return true;
 }
 
-bool InputHelper::isValidDateRange(const std::string& startDate, const std::string& endDate) {
-    return isValidDate(startDate) && isValidDate(endDate) && startDate <= endDate;
+bool InputHelper::isValidDateRange(Date startDate, Date endDate) {
+    return !startDate.isEmpty() && !endDate.isEmpty() && startDate <= endDate;
 }
 
 std::string InputHelper::trim(const std::string& str) {
@@ -249,13 +249,3 @@ std::vector<std::string> InputHelper::getIncomeCategories() {
 std::vector<std::string> InputHelper::getExpenseCategories() {
     return {"餐饮", "住房", "交通", "购物", "娱乐", "医疗", "教育", "水电费", "通讯费", "其他"};
 }
-
-bool InputHelper::isLeapYear(int year) {
-    return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
-}
-
-int InputHelper::getDaysInMonth(int year, int month) {
-    static const int daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-    if (month == 2 && isLeapYear(year)) return 29;
-    return daysInMonth[month - 1];
-}
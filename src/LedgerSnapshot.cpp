@@ -0,0 +1,457 @@
+#include "LedgerSnapshot.h"
+#include "AtomicFile.h"
+#include "MappedFile.h"
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace {
+
+const char SNAPSHOT_MAGIC[4] = {'F', 'F', 'M', 'S'};
+
+// 定长文件头，fileSize 用于识别写了一半的快照
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t fileSize;
+    uint64_t incomeStampSize;
+    int64_t incomeStampTime;
+    uint64_t incomeStampIdentity;
+    uint64_t expenseStampSize;
+    int64_t expenseStampTime;
+    uint64_t expenseStampIdentity;
+    uint32_t dictionaryCount;
+    uint32_t dictionaryBytes;
+    uint32_t incomeCount;
+    uint32_t expenseCount;
+    uint32_t incomeBlocks;
+    uint32_t expenseBlocks;
+    uint64_t incomeDirectoryOffset;
+    uint64_t expenseDirectoryOffset;
+};
+
+const std::string& partyOf(const IncomeRecord& record) { return record.getSource(); }
+const std::string& partyOf(const ExpenseRecord& record) { return record.getPayee(); }
+void setPartyId(IncomeRecord& record, uint32_t id) { record.setSourceId(id); }
+void setPartyId(ExpenseRecord& record, uint32_t id) { record.setPayeeId(id); }
+
+
+uint64_t categoryBit(uint32_t categoryId) {
+    return uint64_t(1) << (categoryId < 63 ? categoryId : 63);
+}
+
+/**
+ * @brief 一个块的列数据，字符串字段映射到共享字典
+ */
+struct ColumnSet {
+    std::vector<int32_t> ids;
+    std::vector<uint32_t> dates;
+    std::vector<uint32_t> categories;
+    std::vector<uint32_t> parties;
+    std::vector<uint32_t> descOffsets;
+    std::vector<int64_t> amounts;
+    std::string descHeap;
+
+    void clear() {
+        ids.clear();
+        dates.clear();
+        categories.clear();
+        parties.clear();
+        descOffsets.assign(1, 0);
+        amounts.clear();
+        descHeap.clear();
+    }
+};
+
+class DictionaryBuilder {
+public:
+    std::vector<std::string> entries;
+
+    uint32_t intern(const std::string& text) {
+        auto it = index.find(text);
+        if (it != index.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(entries.size());
+        index.emplace(text, id);
+        entries.push_back(text);
+        return id;
+    }
+
+private:
+    std::unordered_map<std::string, uint32_t> index;
+};
+
+template <typename T>
+void writeArray(std::ofstream& out, const std::vector<T>& values) {
+    if (!values.empty()) out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+void writePadding(std::ofstream& out) {
+    static const char zeros[8] = {0};
+    std::streamoff pos = out.tellp();
+    if (pos % 8 != 0) out.write(zeros, 8 - pos % 8);
+}
+
+void writeColumns(std::ofstream& out, const ColumnSet& columns) {
+    writeArray(out, columns.ids);
+    writeArray(out, columns.dates);
+    writeArray(out, columns.categories);
+    writeArray(out, columns.parties);
+    writeArray(out, columns.descOffsets);
+    writePadding(out);
+    writeArray(out, columns.amounts);
+    out.write(columns.descHeap.data(), static_cast<std::streamsize>(columns.descHeap.size()));
+    writePadding(out);
+}
+
+// 按 (日期, ID) 排序后分块写出一张表，并返回每块的区间映射
+template <typename T>
+bool writeTable(std::ofstream& out, const std::vector<T>& records, DictionaryBuilder& dictionary,
+                std::vector<ZoneMap>& zones) {
+    std::vector<uint32_t> dates(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (records[i].getDate().isEmpty()) return false;
+        dates[i] = records[i].getDate().getPacked();
+    }
+    std::vector<uint32_t> order(records.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<uint32_t>(i);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        if (dates[a] != dates[b]) return dates[a] < dates[b];
+        return records[a].getId() < records[b].getId();
+    });
+
+    ColumnSet columns;
+    for (size_t begin = 0; begin < order.size(); begin += LedgerSnapshot::BLOCK_RECORDS) {
+        size_t end = std::min<size_t>(order.size(), begin + LedgerSnapshot::BLOCK_RECORDS);
+        columns.clear();
+
+        ZoneMap zone;
+        std::memset(&zone, 0, sizeof(zone));
+        zone.offset = static_cast<uint64_t>(out.tellp());
+        zone.count = static_cast<uint32_t>(end - begin);
+        zone.minDate = dates[order[begin]];
+        zone.maxDate = dates[order[end - 1]];
+        zone.minAmount = std::numeric_limits<int64_t>::max();
+        zone.maxAmount = std::numeric_limits<int64_t>::min();
+
+        for (size_t k = begin; k < end; ++k) {
+            const T& r = records[order[k]];
+            int64_t cents = r.getAmount().getCents();
+            uint32_t category = dictionary.intern(r.getCategory());
+            columns.ids.push_back(r.getId());
+            columns.dates.push_back(dates[order[k]]);
+            columns.amounts.push_back(cents);
+            columns.categories.push_back(category);
+            columns.parties.push_back(dictionary.intern(partyOf(r)));
+            columns.descHeap += r.getDescription();
+            columns.descOffsets.push_back(static_cast<uint32_t>(columns.descHeap.size()));
+
+            zone.minAmount = std::min(zone.minAmount, cents);
+            zone.maxAmount = std::max(zone.maxAmount, cents);
+            zone.categoryBits |= categoryBit(category);
+        }
+        writeColumns(out, columns);
+        zones.push_back(zone);
+    }
+    return true;
+}
+
+/**
+ * @brief 在映射内存上按偏移读取，每次读取一整列
+ */
+class SnapshotCursor {
+public:
+    SnapshotCursor(const char* begin, const char* end) : cur(begin), base(begin), last(end) {}
+
+    bool seek(uint64_t offset) {
+        if (offset > static_cast<uint64_t>(last - base)) return false;
+        cur = base + offset;
+        return true;
+    }
+
+    template <typename T>
+    bool readArray(std::vector<T>& values, size_t count) {
+        size_t bytes = count * sizeof(T);
+        if (static_cast<size_t>(last - cur) < bytes) return false;
+        values.resize(count);
+        if (bytes > 0) std::memcpy(values.data(), cur, bytes);
+        cur += bytes;
+        return true;
+    }
+
+    bool readBytes(std::string& text, size_t count) {
+        if (static_cast<size_t>(last - cur) < count) return false;
+        text.assign(cur, count);
+        cur += count;
+        return true;
+    }
+
+    void skipPadding() {
+        size_t pos = static_cast<size_t>(cur - base);
+        if (pos % 8 != 0) cur += 8 - pos % 8;
+        if (cur > last) cur = last;
+    }
+
+private:
+    const char* cur;
+    const char* base;
+    const char* last;
+};
+
+bool readColumns(SnapshotCursor& cursor, size_t count, ColumnSet& columns) {
+    if (!cursor.readArray(columns.ids, count) ||
+        !cursor.readArray(columns.dates, count) ||
+        !cursor.readArray(columns.categories, count) ||
+        !cursor.readArray(columns.parties, count) ||
+        !cursor.readArray(columns.descOffsets, count + 1)) {
+        return false;
+    }
+    cursor.skipPadding();
+    if (!cursor.readArray(columns.amounts, count)) return false;
+    if (!cursor.readBytes(columns.descHeap, columns.descOffsets[count])) return false;
+    cursor.skipPadding();
+    return true;
+}
+
+/**
+ * @brief 已校验过文件头并读入字典和块目录的快照
+ */
+struct OpenSnapshot {
+    MappedFile file;
+    SnapshotHeader header;
+    std::vector<std::string> dictionary;
+    // 快照字典下标到全局字典 ID 的映射，首次用到时才驻留
+    mutable std::vector<uint32_t> categoryIds;
+    mutable std::vector<uint32_t> partyIds;
+    std::vector<ZoneMap> incomeZones;
+    std::vector<ZoneMap> expenseZones;
+
+    bool open(const std::string& path, const FileStamp& incomeStamp, const FileStamp& expenseStamp) {
+        if (!file.open(path) || file.size() < sizeof(SnapshotHeader)) return false;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+            header.version != LedgerSnapshot::VERSION || header.fileSize != file.size()) {
+            return false;
+        }
+        FileStamp savedIncome, savedExpense;
+        savedIncome.size = header.incomeStampSize;
+        savedIncome.modifiedTime = header.incomeStampTime;
+        savedIncome.identity = header.incomeStampIdentity;
+        savedExpense.size = header.expenseStampSize;
+        savedExpense.modifiedTime = header.expenseStampTime;
+        savedExpense.identity = header.expenseStampIdentity;
+        if (!(savedIncome == incomeStamp) || !(savedExpense == expenseStamp)) return false;
+
+        SnapshotCursor cursor(file.data(), file.end());
+        std::vector<uint32_t> dictOffsets;
+        std::string dictBytes;
+        if (!cursor.seek(sizeof(header)) ||
+            !cursor.readArray(dictOffsets, header.dictionaryCount + 1) ||
+            !cursor.readBytes(dictBytes, header.dictionaryBytes)) {
+            return false;
+        }
+        dictionary.reserve(header.dictionaryCount);
+        for (uint32_t i = 0; i < header.dictionaryCount; ++i) {
+            if (dictOffsets[i] > dictOffsets[i + 1] || dictOffsets[i + 1] > dictBytes.size()) return false;
+            dictionary.push_back(dictBytes.substr(dictOffsets[i], dictOffsets[i + 1] - dictOffsets[i]));
+        }
+        categoryIds.assign(dictionary.size(), StringDictionary::NONE);
+        partyIds.assign(dictionary.size(), StringDictionary::NONE);
+
+        return cursor.seek(header.incomeDirectoryOffset) && cursor.readArray(incomeZones, header.incomeBlocks) &&
+               cursor.seek(header.expenseDirectoryOffset) && cursor.readArray(expenseZones, header.expenseBlocks);
+    }
+
+    // 解码一个块，追加到 records
+    template <typename T>
+    bool decodeBlock(const ZoneMap& zone, ColumnSet& columns, std::vector<T>& records) const {
+        SnapshotCursor cursor(file.data(), file.end());
+        if (!cursor.seek(zone.offset) || !readColumns(cursor, zone.count, columns)) return false;
+        for (size_t i = 0; i < zone.count; ++i) {
+            uint32_t category = columns.categories[i];
+            uint32_t party = columns.parties[i];
+            uint32_t descBegin = columns.descOffsets[i];
+            uint32_t descEnd = columns.descOffsets[i + 1];
+            if (category >= dictionary.size() || party >= dictionary.size() ||
+                descBegin > descEnd || descEnd > columns.descHeap.size()) {
+                return false;
+            }
+            records.emplace_back();
+            T& record = records.back();
+            record.setId(columns.ids[i]);
+            record.setDate(Date::fromPacked(columns.dates[i]));
+            record.setAmount(Money::fromCents(columns.amounts[i]));
+            uint32_t categoryId = globalId(categoryIds, StringDictionary::categories(), category);
+            uint32_t partyId = globalId(partyIds, StringDictionary::parties(), party);
+            // 全局字典已满时放弃快照，改由CSV加载逐行报告
+            if (categoryId == StringDictionary::NONE || partyId == StringDictionary::NONE) return false;
+            record.setCategoryId(categoryId);
+            setPartyId(record, partyId);
+            record.setDescription(std::string(columns.descHeap.data() + descBegin, descEnd - descBegin));
+        }
+        return true;
+    }
+
+    uint32_t globalId(std::vector<uint32_t>& ids, StringDictionary& target, uint32_t index) const {
+        if (ids[index] == StringDictionary::NONE) ids[index] = target.tryIntern(dictionary[index]);
+        return ids[index];
+    }
+};
+
+template <typename T>
+bool readTable(const OpenSnapshot& snapshot, const std::vector<ZoneMap>& zones, size_t count, std::vector<T>& records) {
+    records.clear();
+    records.reserve(count);
+    ColumnSet columns;
+    for (const auto& zone : zones) {
+        if (!snapshot.decodeBlock(zone, columns, records)) return false;
+    }
+    return records.size() == count;
+}
+
+} // namespace
+
+// 把一个64位值混入哈希（splitmix64 的混合步骤）
+static uint64_t mixStamp(uint64_t hash, uint64_t value) {
+    uint64_t z = hash ^ (value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2));
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+FileStamp FileStamp::of(const std::string& path) {
+    FileStamp stamp;
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data)) {
+        stamp.size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+        // FILETIME 以100纳秒为单位
+        uint64_t written = (static_cast<uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+        uint64_t created = (static_cast<uint64_t>(data.ftCreationTime.dwHighDateTime) << 32) | data.ftCreationTime.dwLowDateTime;
+        stamp.modifiedTime = static_cast<int64_t>(written * 100);
+        stamp.identity = mixStamp(0, created);
+    }
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0) {
+        stamp.size = static_cast<uint64_t>(st.st_size);
+#if defined(__APPLE__)
+        const struct timespec& modified = st.st_mtimespec;
+        const struct timespec& changed = st.st_ctimespec;
+#else
+        const struct timespec& modified = st.st_mtim;
+        const struct timespec& changed = st.st_ctim;
+#endif
+        stamp.modifiedTime = static_cast<int64_t>(modified.tv_sec) * 1000000000 + modified.tv_nsec;
+        uint64_t identity = mixStamp(0, static_cast<uint64_t>(st.st_dev));
+        identity = mixStamp(identity, static_cast<uint64_t>(st.st_ino));
+        identity = mixStamp(identity, static_cast<uint64_t>(changed.tv_sec) * 1000000000 + static_cast<uint64_t>(changed.tv_nsec));
+        stamp.identity = identity;
+    }
+#endif
+    return stamp;
+}
+
+void FileStamp::combine(const std::string& name, const FileStamp& part) {
+    uint64_t nameHash = 0;
+    for (unsigned char c : name) nameHash = mixStamp(nameHash, c);
+    size += part.size;
+    modifiedTime = std::max(modifiedTime, part.modifiedTime);
+    identity = mixStamp(identity, nameHash);
+    identity = mixStamp(identity, part.size);
+    identity = mixStamp(identity, static_cast<uint64_t>(part.modifiedTime));
+    identity = mixStamp(identity, part.identity);
+}
+
+bool FileStamp::operator==(const FileStamp& other) const {
+    return size == other.size && modifiedTime == other.modifiedTime && identity == other.identity;
+}
+
+bool LedgerSnapshot::write(const std::string& path,
+                           const std::vector<IncomeRecord>& income,
+                           const std::vector<ExpenseRecord>& expense,
+                           const FileStamp& incomeStamp, const FileStamp& expenseStamp) {
+    // 先登记全部分类，使分类的字典编号尽量小，分类位图可以精确表示
+    DictionaryBuilder dictionary;
+    for (const auto& r : income) dictionary.intern(r.getCategory());
+    for (const auto& r : expense) dictionary.intern(r.getCategory());
+    for (const auto& r : income) dictionary.intern(r.getSource());
+    for (const auto& r : expense) dictionary.intern(r.getPayee());
+
+    std::vector<uint32_t> dictOffsets(1, 0);
+    std::string dictBytes;
+    for (const auto& entry : dictionary.entries) {
+        dictBytes += entry;
+        dictOffsets.push_back(static_cast<uint32_t>(dictBytes.size()));
+    }
+
+    // 写入临时文件，完成后原子替换，避免中途崩溃留下损坏的快照
+    std::string tempPath = AtomicFile::tempPathOf(path);
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = VERSION;
+    header.incomeStampSize = incomeStamp.size;
+    header.incomeStampTime = incomeStamp.modifiedTime;
+    header.incomeStampIdentity = incomeStamp.identity;
+    header.expenseStampSize = expenseStamp.size;
+    header.expenseStampTime = expenseStamp.modifiedTime;
+    header.expenseStampIdentity = expenseStamp.identity;
+    header.dictionaryCount = static_cast<uint32_t>(dictionary.entries.size());
+    header.dictionaryBytes = static_cast<uint32_t>(dictBytes.size());
+    header.incomeCount = static_cast<uint32_t>(income.size());
+    header.expenseCount = static_cast<uint32_t>(expense.size());
+
+    // 文件头最后回填总长度和块目录位置，写到一半的快照会因长度不符被拒绝
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeArray(out, dictOffsets);
+    out.write(dictBytes.data(), static_cast<std::streamsize>(dictBytes.size()));
+    writePadding(out);
+
+    std::vector<ZoneMap> incomeZones, expenseZones;
+    if (!writeTable(out, income, dictionary, incomeZones) || !writeTable(out, expense, dictionary, expenseZones)) {
+        out.close();
+        std::remove(tempPath.c_str());
+        std::remove(path.c_str());
+        return false;
+    }
+    header.incomeBlocks = static_cast<uint32_t>(incomeZones.size());
+    header.expenseBlocks = static_cast<uint32_t>(expenseZones.size());
+    header.incomeDirectoryOffset = static_cast<uint64_t>(out.tellp());
+    writeArray(out, incomeZones);
+    header.expenseDirectoryOffset = static_cast<uint64_t>(out.tellp());
+    writeArray(out, expenseZones);
+
+    header.fileSize = static_cast<uint64_t>(out.tellp());
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    if (out.fail()) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return AtomicFile::commit(tempPath, path);
+}
+
+bool LedgerSnapshot::read(const std::string& path,
+                          std::vector<IncomeRecord>& income,
+                          std::vector<ExpenseRecord>& expense,
+                          const FileStamp& incomeStamp, const FileStamp& expenseStamp) {
+    OpenSnapshot snapshot;
+    if (!snapshot.open(path, incomeStamp, expenseStamp)) return false;
+    return readTable(snapshot, snapshot.incomeZones, snapshot.header.incomeCount, income) &&
+           readTable(snapshot, snapshot.expenseZones, snapshot.header.expenseCount, expense);
+}
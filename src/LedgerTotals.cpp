@@ -0,0 +1,60 @@
+#include "LedgerTotals.h"
+
+LedgerTotals::LedgerTotals() {}
+
+void LedgerTotals::clear() {
+    total = Bucket();
+    months.clear();
+    categories.clear();
+    daily.clear();
+    dailyByCategory.clear();
+}
+
+void LedgerTotals::addToBuckets(uint32_t date, uint32_t category, int64_t cents) {
+    total.cents += cents;
+    ++total.count;
+    Bucket& month = months[date / 100];
+    month.cents += cents;
+    ++month.count;
+    if (category >= categories.size()) categories.resize(category + 1);
+    categories[category].cents += cents;
+    ++categories[category].count;
+}
+
+void LedgerTotals::add(uint32_t date, uint32_t category, int64_t cents) {
+    addToBuckets(date, category, cents);
+    daily.add(Date::fromPacked(date), cents);
+    dailyByCategory[category].add(Date::fromPacked(date), cents);
+}
+
+void LedgerTotals::append(uint32_t date, uint32_t category, int64_t cents) {
+    addToBuckets(date, category, cents);
+    daily.append(Date::fromPacked(date), cents);
+    dailyByCategory[category].append(Date::fromPacked(date), cents);
+}
+
+void LedgerTotals::finish() {
+    daily.finish();
+    for (auto& p : dailyByCategory) p.second.finish();
+}
+
+void LedgerTotals::remove(uint32_t date, uint32_t category, int64_t cents) {
+    total.cents -= cents;
+    --total.count;
+    auto month = months.find(date / 100);
+    if (month != months.end()) {
+        month->second.cents -= cents;
+        if (--month->second.count == 0) months.erase(month);
+    }
+    if (category < categories.size()) {
+        categories[category].cents -= cents;
+        --categories[category].count;
+    }
+    daily.add(Date::fromPacked(date), -cents);
+    // 分类的最后一条记录删除后连同按天累计一起释放
+    auto categoryDaily = dailyByCategory.find(category);
+    if (categoryDaily != dailyByCategory.end()) {
+        if (category < categories.size() && categories[category].count == 0) dailyByCategory.erase(categoryDaily);
+        else categoryDaily->second.add(Date::fromPacked(date), -cents);
+    }
+}
@@ -0,0 +1,84 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() : ptr(nullptr), length(0), fileHandle(INVALID_HANDLE_VALUE), mapHandle(nullptr) {}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) { close(); return false; }
+    length = static_cast<size_t>(fileSize.QuadPart);
+    if (length == 0) return true;
+
+    mapHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapHandle) { close(); return false; }
+    ptr = static_cast<const char*>(MapViewOfFile(mapHandle, FILE_MAP_READ, 0, 0, 0));
+    if (!ptr) { close(); return false; }
+    return true;
+}
+
+void MappedFile::close() {
+    if (ptr) UnmapViewOfFile(ptr);
+    if (mapHandle) CloseHandle(mapHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+    ptr = nullptr;
+    length = 0;
+    mapHandle = nullptr;
+    fileHandle = INVALID_HANDLE_VALUE;
+}
+
+bool MappedFile::isOpen() const { return fileHandle != INVALID_HANDLE_VALUE; }
+
+#else
+
+MappedFile::MappedFile() : ptr(nullptr), length(0), fd(-1) {}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(); return false; }
+    length = static_cast<size_t>(st.st_size);
+    if (length == 0) return true;
+
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) { close(); return false; }
+    ptr = static_cast<const char*>(mapped);
+    madvise(mapped, length, MADV_SEQUENTIAL);
+    return true;
+}
+
+void MappedFile::close() {
+    if (ptr) munmap(const_cast<char*>(ptr), length);
+    if (fd >= 0) ::close(fd);
+    ptr = nullptr;
+    length = 0;
+    fd = -1;
+}
+
+bool MappedFile::isOpen() const { return fd >= 0; }
+
+#endif
+
+MappedFile::MappedFile(const std::string& path) : MappedFile() { open(path); }
+MappedFile::~MappedFile() { close(); }
+
+const char* MappedFile::data() const { return ptr; }
+const char* MappedFile::end() const { return ptr + length; }
+size_t MappedFile::size() const { return length; }
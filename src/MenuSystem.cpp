@@ -2,6 +2,8 @@
 #include "InputHelper.h"
 #include "DisplayHelper.h"
 #include <iostream>
+#include <algorithm>
+#include <climits>
 
 MenuSystem::MenuSystem(FinanceManager& mgr) : manager(mgr), reporter(mgr), running(true) {}
 
@@ -38,6 +40,8 @@ void MenuSystem::displayStatisticsMenu() {
     std::cout << "  1. 月度收支汇总" << std::endl;
     std::cout << "  2. 分类统计" << std::endl;
     std::cout << "  3. 财务总览" << std::endl;
+    std::cout << "  4. 区间收支与结余" << std::endl;
+    std::cout << "  5. 完整统计报表" << std::endl;
     std::cout << "  0. 返回主菜单" << std::endl << std::endl;
 }
 
@@ -52,8 +56,9 @@ void MenuSystem::run() {
             case 3: handleStatisticsMenu(); break;
             case 0:
                 if (InputHelper::getConfirmation("确定要退出系统吗？")) {
-                    manager.saveAll();
-                    DisplayHelper::printSuccess("数据已保存，感谢使用！");
+                    // 修改已经写入日志，退出前只需等待后台持久化线程落盘
+                    if (manager.flush()) DisplayHelper::printSuccess("数据已保存，感谢使用！");
+                    else DisplayHelper::printMessage("数据保存失败！", true);
                     running = false;
                 }
                 break;
@@ -100,11 +105,31 @@ void MenuSystem::handleStatisticsMenu() {
     while (inSubmenu) {
         DisplayHelper::clearScreen();
         displayStatisticsMenu();
-        int choice = InputHelper::getMenuChoice(0, 3);
+        int choice = InputHelper::getMenuChoice(0, 5);
         switch (choice) {
             case 1: reporter.printMonthlySummary(); InputHelper::pauseScreen(); break;
             case 2: reporter.printCategoryBreakdown(); InputHelper::pauseScreen(); break;
             case 3: reporter.printOverallSummary(); InputHelper::pauseScreen(); break;
+            case 4: {
+                Date startDate = InputHelper::getDate("请输入开始日期");
+                Date endDate = InputHelper::getDate("请输入结束日期");
+                if (startDate > endDate) DisplayHelper::printMessage("开始日期不能晚于结束日期！", true);
+                else reporter.printDateRangeSummary(startDate, endDate);
+                InputHelper::pauseScreen();
+                break;
+            }
+            case 5: {
+                if (InputHelper::getConfirmation("是否限定日期区间？")) {
+                    Date startDate = InputHelper::getDate("请输入开始日期");
+                    Date endDate = InputHelper::getDate("请输入结束日期");
+                    if (startDate > endDate) DisplayHelper::printMessage("开始日期不能晚于结束日期！", true);
+                    else reporter.printFullReport(startDate, endDate);
+                } else {
+                    reporter.printFullReport();
+                }
+                InputHelper::pauseScreen();
+                break;
+            }
             case 0: inSubmenu = false; break;
         }
     }
@@ -113,8 +138,8 @@ void MenuSystem::handleStatisticsMenu() {
 void MenuSystem::addIncomeRecord() {
     DisplayHelper::clearScreen();
     DisplayHelper::printSubHeader("添加收入记录");
-    std::string date = InputHelper::getDate("请输入日期");
-    double amount = InputHelper::getAmount("请输入金额: ");
+    Date date = InputHelper::getDate("请输入日期");
+    Money amount = InputHelper::getAmount("请输入金额: ");
     std::string category = InputHelper::getCategory("请选择分类", InputHelper::getIncomeCategories());
     std::string source = InputHelper::getString("请输入来源: ");
     std::string description = InputHelper::getString("请输入描述 (可选): ", false);
@@ -137,51 +162,91 @@ void MenuSystem::queryIncomeRecords() {
     std::cout << "  1. 查询所有记录" << std::endl;
     std::cout << "  2. 按日期范围查询" << std::endl;
     std::cout << "  3. 按分类查询" << std::endl;
+    std::cout << "  4. 按分类和日期范围查询" << std::endl;
+    std::cout << "  5. 按关键词搜索描述或来源" << std::endl;
+    std::cout << "  6. 金额最高的前N条" << std::endl;
+    std::cout << "  7. 最近的N条" << std::endl;
     std::cout << "  0. 返回" << std::endl << std::endl;
     
-    int choice = InputHelper::getMenuChoice(0, 3);
-    std::vector<IncomeRecord> results;
+    int choice = InputHelper::getMenuChoice(0, 7);
+    RecordView<IncomeRecord> results;
     
     switch (choice) {
-        case 1: results = manager.getAllIncome(); break;
+        case 1: results = manager.viewIncome(); break;
         case 2: {
-            std::string startDate = InputHelper::getDate("请输入开始日期");
-            std::string endDate = InputHelper::getDate("请输入结束日期");
+            Date startDate = InputHelper::getDate("请输入开始日期");
+            Date endDate = InputHelper::getDate("请输入结束日期");
             if (startDate > endDate) { DisplayHelper::printMessage("开始日期不能晚于结束日期！", true); InputHelper::pauseScreen(); return; }
-            results = manager.queryIncomeByDateRange(startDate, endDate);
+            results = manager.viewIncomeByDateRange(startDate, endDate);
+            break;
+        }
+        case 3: results = manager.viewIncomeByCategory(InputHelper::getCategory("请选择分类", InputHelper::getIncomeCategories())); break;
+        case 4: {
+            std::string category = InputHelper::getCategory("请选择分类", InputHelper::getIncomeCategories());
+            Date startDate = InputHelper::getDate("请输入开始日期");
+            Date endDate = InputHelper::getDate("请输入结束日期");
+            if (startDate > endDate) { DisplayHelper::printMessage("开始日期不能晚于结束日期！", true); InputHelper::pauseScreen(); return; }
+            results = manager.viewIncomeByCategoryAndDateRange(category, startDate, endDate);
+            break;
+        }
+        case 5: results = manager.viewIncomeByKeyword(InputHelper::getString("请输入关键词")); break;
+        case 6: {
+            int count = InputHelper::getCount("请输入条数", 10);
+            RecordView<IncomeRecord> scope;
+            if (!chooseIncomeScope(scope)) { DisplayHelper::printMessage("开始日期不能晚于结束日期！", true); InputHelper::pauseScreen(); return; }
+            results = scope.topByAmount(static_cast<size_t>(count));
             break;
         }
-        case 3: results = manager.queryIncomeByCategory(InputHelper::getCategory("请选择分类", InputHelper::getIncomeCategories())); break;
+        case 7: results = manager.viewIncome().latest(static_cast<size_t>(InputHelper::getCount("请输入条数", 10))); break;
         case 0: return;
     }
-    displayIncomeList(results);
+    browseIncomeList(results);
     InputHelper::pauseScreen();
 }
 
+bool MenuSystem::chooseIncomeScope(RecordView<IncomeRecord>& scope) {
+    std::cout << "  1. 全部记录" << std::endl;
+    std::cout << "  2. 按日期范围" << std::endl;
+    std::cout << "  3. 按分类" << std::endl;
+    switch (InputHelper::getMenuChoice(1, 3)) {
+        case 2: {
+            Date startDate = InputHelper::getDate("请输入开始日期");
+            Date endDate = InputHelper::getDate("请输入结束日期");
+            if (startDate > endDate) return false;
+            scope = manager.viewIncomeByDateRange(startDate, endDate);
+            return true;
+        }
+        case 3: scope = manager.viewIncomeByCategory(InputHelper::getCategory("请选择分类", InputHelper::getIncomeCategories())); return true;
+        default: scope = manager.viewIncome(); return true;
+    }
+}
+
 void MenuSystem::modifyIncomeRecord() {
     DisplayHelper::clearScreen();
     DisplayHelper::printSubHeader("修改收入记录");
-    auto records = manager.getAllIncome();
+    auto records = manager.viewIncome();
     if (records.empty()) { DisplayHelper::printInfo("暂无收入记录可修改。"); InputHelper::pauseScreen(); return; }
-    displayIncomeList(records);
+    browseIncomeList(records);
     
     int id = InputHelper::getRecordId("请输入要修改的记录ID: ");
-    IncomeRecord* record = manager.getIncomeById(id);
-    if (!record) { DisplayHelper::printMessage("未找到该记录！", true); InputHelper::pauseScreen(); return; }
+    IncomeRecord record;
+    if (!manager.getIncomeById(id, record)) { DisplayHelper::printMessage("未找到该记录！", true); InputHelper::pauseScreen(); return; }
     
     std::cout << std::endl << "当前记录信息：" << std::endl;
-    record->display();
+    record.display();
     std::cout << std::endl << "请输入新值（直接回车保持原值）：" << std::endl;
     
-    std::string newDate = InputHelper::getString("新日期 [" + record->getDate() + "]: ", false);
-    std::string amountStr = InputHelper::getString("新金额 [" + std::to_string(record->getAmount()) + "]: ", false);
-    std::string newCategory = InputHelper::getString("新分类 [" + record->getCategory() + "]: ", false);
-    std::string newSource = InputHelper::getString("新来源 [" + record->getSource() + "]: ", false);
-    std::string newDesc = InputHelper::getString("新描述 [" + record->getDescription() + "]: ", false);
+    std::string dateStr = InputHelper::getString("新日期 [" + record.getDate().toString() + "]: ", false);
+    std::string amountStr = InputHelper::getString("新金额 [" + record.getAmount().toString() + "]: ", false);
+    std::string newCategory = InputHelper::getString("新分类 [" + record.getCategory() + "]: ", false);
+    std::string newSource = InputHelper::getString("新来源 [" + record.getSource() + "]: ", false);
+    std::string newDesc = InputHelper::getString("新描述 [" + record.getDescription() + "]: ", false);
     
     IncomeRecord newData;
-    newData.setDate(newDate);
-    if (!amountStr.empty() && InputHelper::isNumeric(amountStr)) newData.setAmount(std::stod(amountStr));
+    Date newDate;
+    if (!dateStr.empty() && Date::parse(dateStr, newDate) == ParseStatus::Ok) newData.setDate(newDate);
+    Money newAmount;
+    if (!amountStr.empty() && Money::parse(amountStr, newAmount) == ParseStatus::Ok) newData.setAmount(newAmount);
     newData.setCategory(newCategory);
     newData.setSource(newSource);
     newData.setDescription(newDesc);
@@ -196,16 +261,16 @@ void MenuSystem::modifyIncomeRecord() {
 void MenuSystem::deleteIncomeRecord() {
     DisplayHelper::clearScreen();
     DisplayHelper::printSubHeader("删除收入记录");
-    auto records = manager.getAllIncome();
+    auto records = manager.viewIncome();
     if (records.empty()) { DisplayHelper::printInfo("暂无收入记录可删除。"); InputHelper::pauseScreen(); return; }
-    displayIncomeList(records);
+    browseIncomeList(records);
     
     int id = InputHelper::getRecordId("请输入要删除的记录ID: ");
-    const IncomeRecord* record = manager.getIncomeById(id);
-    if (!record) { DisplayHelper::printMessage("未找到该记录！", true); InputHelper::pauseScreen(); return; }
+    IncomeRecord record;
+    if (!manager.getIncomeById(id, record)) { DisplayHelper::printMessage("未找到该记录！", true); InputHelper::pauseScreen(); return; }
     
     std::cout << std::endl << "即将删除以下记录：" << std::endl;
-    record->display();
+    record.display();
     
     if (InputHelper::getConfirmation("确认删除？此操作不可恢复！")) {
         if (manager.deleteIncome(id)) DisplayHelper::printSuccess("记录删除成功！");
@@ -235,8 +300,8 @@ void MenuSystem::printIncomeRecords() {
 void MenuSystem::addExpenseRecord() {
     DisplayHelper::clearScreen();
     DisplayHelper::printSubHeader("添加支出记录");
-    std::string date = InputHelper::getDate("请输入日期");
-    double amount = InputHelper::getAmount("请输入金额: ");
+    Date date = InputHelper::getDate("请输入日期");
+    Money amount = InputHelper::getAmount("请输入金额: ");
     std::string category = InputHelper::getCategory("请选择分类", InputHelper::getExpenseCategories());
     std::string payee = InputHelper::getString("请输入支付对象: ");
     std::string description = InputHelper::getString("请输入描述 (可选): ", false);
@@ -259,51 +324,91 @@ void MenuSystem::queryExpenseRecords() {
     std::cout << "  1. 查询所有记录" << std::endl;
     std::cout << "  2. 按日期范围查询" << std::endl;
     std::cout << "  3. 按分类查询" << std::endl;
+    std::cout << "  4. 按分类和日期范围查询" << std::endl;
+    std::cout << "  5. 按关键词搜索描述或支付对象" << std::endl;
+    std::cout << "  6. 金额最高的前N条" << std::endl;
+    std::cout << "  7. 最近的N条" << std::endl;
     std::cout << "  0. 返回" << std::endl << std::endl;
     
-    int choice = InputHelper::getMenuChoice(0, 3);
-    std::vector<ExpenseRecord> results;
+    int choice = InputHelper::getMenuChoice(0, 7);
+    RecordView<ExpenseRecord> results;
     
     switch (choice) {
-        case 1: results = manager.getAllExpense(); break;
+        case 1: results = manager.viewExpense(); break;
         case 2: {
-            std::string startDate = InputHelper::getDate("请输入开始日期");
-            std::string endDate = InputHelper::getDate("请输入结束日期");
+            Date startDate = InputHelper::getDate("请输入开始日期");
+            Date endDate = InputHelper::getDate("请输入结束日期");
             if (startDate > endDate) { DisplayHelper::printMessage("开始日期不能晚于结束日期！", true); InputHelper::pauseScreen(); return; }
-            results = manager.queryExpenseByDateRange(startDate, endDate);
+            results = manager.viewExpenseByDateRange(startDate, endDate);
             break;
         }
-        case 3: results = manager.queryExpenseByCategory(InputHelper::getCategory("请选择分类", InputHelper::getExpenseCategories())); break;
+        case 3: results = manager.viewExpenseByCategory(InputHelper::getCategory("请选择分类", InputHelper::getExpenseCategories())); break;
+        case 4: {
+            std::string category = InputHelper::getCategory("请选择分类", InputHelper::getExpenseCategories());
+            Date startDate = InputHelper::getDate("请输入开始日期");
+            Date endDate = InputHelper::getDate("请输入结束日期");
+            if (startDate > endDate) { DisplayHelper::printMessage("开始日期不能晚于结束日期！", true); InputHelper::pauseScreen(); return; }
+            results = manager.viewExpenseByCategoryAndDateRange(category, startDate, endDate);
+            break;
+        }
+        case 5: results = manager.viewExpenseByKeyword(InputHelper::getString("请输入关键词")); break;
+        case 6: {
+            int count = InputHelper::getCount("请输入条数", 10);
+            RecordView<ExpenseRecord> scope;
+            if (!chooseExpenseScope(scope)) { DisplayHelper::printMessage("开始日期不能晚于结束日期！", true); InputHelper::pauseScreen(); return; }
+            results = scope.topByAmount(static_cast<size_t>(count));
+            break;
+        }
+        case 7: results = manager.viewExpense().latest(static_cast<size_t>(InputHelper::getCount("请输入条数", 10))); break;
         case 0: return;
     }
-    displayExpenseList(results);
+    browseExpenseList(results);
     InputHelper::pauseScreen();
 }
 
+bool MenuSystem::chooseExpenseScope(RecordView<ExpenseRecord>& scope) {
+    std::cout << "  1. 全部记录" << std::endl;
+    std::cout << "  2. 按日期范围" << std::endl;
+    std::cout << "  3. 按分类" << std::endl;
+    switch (InputHelper::getMenuChoice(1, 3)) {
+        case 2: {
+            Date startDate = InputHelper::getDate("请输入开始日期");
+            Date endDate = InputHelper::getDate("请输入结束日期");
+            if (startDate > endDate) return false;
+            scope = manager.viewExpenseByDateRange(startDate, endDate);
+            return true;
+        }
+        case 3: scope = manager.viewExpenseByCategory(InputHelper::getCategory("请选择分类", InputHelper::getExpenseCategories())); return true;
+        default: scope = manager.viewExpense(); return true;
+    }
+}
+
 void MenuSystem::modifyExpenseRecord() {
     DisplayHelper::clearScreen();
     DisplayHelper::printSubHeader("修改支出记录");
-    auto records = manager.getAllExpense();
+    auto records = manager.viewExpense();
     if (records.empty()) { DisplayHelper::printInfo("暂无支出记录可修改。"); InputHelper::pauseScreen(); return; }
-    displayExpenseList(records);
+    browseExpenseList(records);
     
     int id = InputHelper::getRecordId("请输入要修改的记录ID: ");
-    ExpenseRecord* record = manager.getExpenseById(id);
-    if (!record) { DisplayHelper::printMessage("未找到该记录！", true); InputHelper::pauseScreen(); return; }
+    ExpenseRecord record;
+    if (!manager.getExpenseById(id, record)) { DisplayHelper::printMessage("未找到该记录！", true); InputHelper::pauseScreen(); return; }
     
     std::cout << std::endl << "当前记录信息：" << std::endl;
-    record->display();
+    record.display();
     std::cout << std::endl << "请输入新值（直接回车保持原值）：" << std::endl;
     
-    std::string newDate = InputHelper::getString("新日期 [" + record->getDate() + "]: ", false);
-    std::string amountStr = InputHelper::getString("新金额 [" + std::to_string(record->getAmount()) + "]: ", false);
-    std::string newCategory = InputHelper::getString("新分类 [" + record->getCategory() + "]: ", false);
-    std::string newPayee = InputHelper::getString("新支付对象 [" + record->getPayee() + "]: ", false);
-    std::string newDesc = InputHelper::getString("新描述 [" + record->getDescription() + "]: ", false);
+    std::string dateStr = InputHelper::getString("新日期 [" + record.getDate().toString() + "]: ", false);
+    std::string amountStr = InputHelper::getString("新金额 [" + record.getAmount().toString() + "]: ", false);
+    std::string newCategory = InputHelper::getString("新分类 [" + record.getCategory() + "]: ", false);
+    std::string newPayee = InputHelper::getString("新支付对象 [" + record.getPayee() + "]: ", false);
+    std::string newDesc = InputHelper::getString("新描述 [" + record.getDescription() + "]: ", false);
     
     ExpenseRecord newData;
-    newData.setDate(newDate);
-    if (!amountStr.empty() && InputHelper::isNumeric(amountStr)) newData.setAmount(std::stod(amountStr));
+    Date newDate;
+    if (!dateStr.empty() && Date::parse(dateStr, newDate) == ParseStatus::Ok) newData.setDate(newDate);
+    Money newAmount;
+    if (!amountStr.empty() && Money::parse(amountStr, newAmount) == ParseStatus::Ok) newData.setAmount(newAmount);
     newData.setCategory(newCategory);
     newData.setPayee(newPayee);
     newData.setDescription(newDesc);
@@ -318,16 +423,16 @@ void MenuSystem::modifyExpenseRecord() {
 void MenuSystem::deleteExpenseRecord() {
     DisplayHelper::clearScreen();
     DisplayHelper::printSubHeader("删除支出记录");
-    auto records = manager.getAllExpense();
+    auto records = manager.viewExpense();
     if (records.empty()) { DisplayHelper::printInfo("暂无支出记录可删除。"); InputHelper::pauseScreen(); return; }
-    displayExpenseList(records);
+    browseExpenseList(records);
     
     int id = InputHelper::getRecordId("请输入要删除的记录ID: ");
-    const ExpenseRecord* record = manager.getExpenseById(id);
-    if (!record) { DisplayHelper::printMessage("未找到该记录！", true); InputHelper::pauseScreen(); return; }
+    ExpenseRecord record;
+    if (!manager.getExpenseById(id, record)) { DisplayHelper::printMessage("未找到该记录！", true); InputHelper::pauseScreen(); return; }
     
     std::cout << std::endl << "即将删除以下记录：" << std::endl;
-    record->display();
+    record.display();
     
     if (InputHelper::getConfirmation("确认删除？此操作不可恢复！")) {
         if (manager.deleteExpense(id)) DisplayHelper::printSuccess("记录删除成功！");
@@ -354,30 +459,74 @@ void MenuSystem::printExpenseRecords() {
     InputHelper::pauseScreen();
 }
 
-void MenuSystem::displayIncomeList(const std::vector<IncomeRecord>& records) {
+void MenuSystem::displayIncomeList(const RecordView<IncomeRecord>& records, size_t offset, size_t limit) {
     if (records.empty()) { DisplayHelper::printInfo("没有找到符合条件的记录。"); return; }
     std::vector<std::string> headers = {"ID", "日期", "金额", "分类", "来源"};
     std::vector<int> widths = {6, 12, 14, 10, 15};
     DisplayHelper::printTableHeader(headers, widths);
-    double total = 0.0;
-    for (const auto& r : records) {
-        DisplayHelper::printTableRow({std::to_string(r.getId()), r.getDate(), DisplayHelper::formatAmount(r.getAmount()), r.getCategory(), r.getSource()}, widths);
+    Money total;
+    size_t shown = 0;
+    for (const auto& r : records.page(offset, limit)) {
+        DisplayHelper::printTableRow({std::to_string(r.getId()), r.getDate().toString(), DisplayHelper::formatAmount(r.getAmount()), r.getCategory(), r.getParty()}, widths);
         total += r.getAmount();
+        ++shown;
+    }
+    DisplayHelper::printTableFooter(widths);
+    size_t count = records.size();
+    if (shown == count) {
+        std::cout << std::endl << "共 " << count << " 条记录，总计: " << DisplayHelper::formatAmount(total) << std::endl;
+    } else {
+        // 只汇总当前页，不为显示一页而扫描全部结果
+        std::cout << std::endl << "第 " << offset + 1 << "-" << offset + shown << " 条，共 " << count
+                  << " 条记录，本页合计: " << DisplayHelper::formatAmount(total) << std::endl;
+    }
+}
+
+void MenuSystem::browseIncomeList(const RecordView<IncomeRecord>& records) {
+    size_t pages = (records.size() + PAGE_SIZE - 1) / PAGE_SIZE;
+    size_t page = 0;
+    while (true) {
+        displayIncomeList(records, page * PAGE_SIZE, PAGE_SIZE);
+        if (pages <= 1) return;
+        std::cout << "当前第 " << page + 1 << "/" << pages << " 页，输入页码翻页，输入 0 结束浏览" << std::endl;
+        int choice = InputHelper::getMenuChoice(0, static_cast<int>(std::min<size_t>(pages, INT_MAX)));
+        if (choice == 0) return;
+        page = static_cast<size_t>(choice - 1);
     }
-    std::cout << "└"; for (size_t i = 0; i < widths.size(); ++i) { std::cout << std::string(widths[i], '─'); if (i < widths.size() - 1) std::cout << "┴"; } std::cout << "┘" << std::endl;
-    std::cout << std::endl << "共 " << records.size() << " 条记录，总计: " << DisplayHelper::formatAmount(total) << std::endl;
 }
 
-void MenuSystem::displayExpenseList(const std::vector<ExpenseRecord>& records) {
+void MenuSystem::displayExpenseList(const RecordView<ExpenseRecord>& records, size_t offset, size_t limit) {
     if (records.empty()) { DisplayHelper::printInfo("没有找到符合条件的记录。"); return; }
     std::vector<std::string> headers = {"ID", "日期", "金额", "分类", "支付对象"};
     std::vector<int> widths = {6, 12, 14, 10, 15};
     DisplayHelper::printTableHeader(headers, widths);
-    double total = 0.0;
-    for (const auto& r : records) {
-        DisplayHelper::printTableRow({std::to_string(r.getId()), r.getDate(), DisplayHelper::formatAmount(r.getAmount()), r.getCategory(), r.getPayee()}, widths);
+    Money total;
+    size_t shown = 0;
+    for (const auto& r : records.page(offset, limit)) {
+        DisplayHelper::printTableRow({std::to_string(r.getId()), r.getDate().toString(), DisplayHelper::formatAmount(r.getAmount()), r.getCategory(), r.getParty()}, widths);
         total += r.getAmount();
+        ++shown;
+    }
+    DisplayHelper::printTableFooter(widths);
+    size_t count = records.size();
+    if (shown == count) {
+        std::cout << std::endl << "共 " << count << " 条记录，总计: " << DisplayHelper::formatAmount(total) << std::endl;
+    } else {
+        // 只汇总当前页，不为显示一页而扫描全部结果
+        std::cout << std::endl << "第 " << offset + 1 << "-" << offset + shown << " 条，共 " << count
+                  << " 条记录，本页合计: " << DisplayHelper::formatAmount(total) << std::endl;
+    }
+}
+
+void MenuSystem::browseExpenseList(const RecordView<ExpenseRecord>& records) {
+    size_t pages = (records.size() + PAGE_SIZE - 1) / PAGE_SIZE;
+    size_t page = 0;
+    while (true) {
+        displayExpenseList(records, page * PAGE_SIZE, PAGE_SIZE);
+        if (pages <= 1) return;
+        std::cout << "当前第 " << page + 1 << "/" << pages << " 页，输入页码翻页，输入 0 结束浏览" << std::endl;
+        int choice = InputHelper::getMenuChoice(0, static_cast<int>(std::min<size_t>(pages, INT_MAX)));
+        if (choice == 0) return;
+        page = static_cast<size_t>(choice - 1);
     }
-    std::cout << "└"; for (size_t i = 0; i < widths.size(); ++i) { std::cout << std::string(widths[i], '─'); if (i < widths.size() - 1) std::cout << "┴"; } std::cout << "┘" << std::endl;
-    std::cout << std::endl << "共 " << records.size() << " 条记录，总计: " << DisplayHelper::formatAmount(total) << std::endl;
 }
@@ -0,0 +1,42 @@
+#include "Money.h"
+#include <cmath>
+
+Money Money::fromYuan(double yuan) {
+    return Money(static_cast<int64_t>(std::llround(yuan * 100.0)));
+}
+
+ParseStatus Money::parse(const char* data, size_t size, Money& out) {
+    int64_t value = 0;
+    ParseStatus status = NumberParser::parseCents(data, size, value);
+    if (status == ParseStatus::Ok) out = Money(value);
+    return status;
+}
+
+ParseStatus Money::parse(const std::string& text, Money& out) {
+    return parse(text.data(), text.size(), out);
+}
+
+std::string Money::toString() const {
+    std::string text;
+    appendTo(text);
+    return text;
+}
+
+void Money::appendTo(std::string& out) const {
+    // 从低位向高位写入栈上的缓冲区，避免 snprintf 的格式解析
+    char buffer[32];
+    char* end = buffer + sizeof(buffer);
+    char* p = end;
+    uint64_t magnitude = cents < 0 ? 0 - static_cast<uint64_t>(cents) : static_cast<uint64_t>(cents);
+    *--p = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+    *--p = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+    *--p = '.';
+    do {
+        *--p = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (cents < 0) *--p = '-';
+    out.append(p, end);
+}
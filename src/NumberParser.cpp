@@ -0,0 +1,142 @@
+#include "NumberParser.h"
+#include <cmath>
+#include <cstdlib>
+#include <climits>
+#include <cstdint>
+
+static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// 去掉首尾空格
+static void trim(const char*& p, const char*& end) {
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    while (end > p && (end[-1] == ' ' || end[-1] == '\t')) --end;
+}
+
+/**
+ * 扫描可带千分位逗号的整数部分，把数字依次交给 digit(c)。
+ * 出现逗号时第一组为1~3位，之后每组必须正好3位。
+ */
+template <typename DigitFn>
+static ParseStatus scanGroupedDigits(const char*& p, const char* end, size_t& digitCount, DigitFn digit) {
+    size_t groupLength = 0;
+    bool grouped = false;
+    digitCount = 0;
+    for (; p < end; ++p) {
+        if (isDigit(*p)) {
+            digit(*p);
+            ++groupLength;
+            ++digitCount;
+        } else if (*p == ',') {
+            if (groupLength == 0 || (grouped ? groupLength != 3 : groupLength > 3)) return ParseStatus::BadGrouping;
+            grouped = true;
+            groupLength = 0;
+        } else {
+            break;
+        }
+    }
+    if (grouped && groupLength != 3) return ParseStatus::BadGrouping;
+    return ParseStatus::Ok;
+}
+
+ParseStatus NumberParser::parseInt(const char* data, size_t size, int& out) {
+    const char* p = data;
+    const char* end = data + size;
+    trim(p, end);
+    if (p == end) return ParseStatus::Empty;
+
+    bool negative = false;
+    if (*p == '-' || *p == '+') negative = (*p++ == '-');
+
+    long long value = 0;
+    bool overflow = false;
+    size_t digits = 0;
+    ParseStatus status = scanGroupedDigits(p, end, digits, [&](char c) {
+        value = value * 10 + (c - '0');
+        if (value > static_cast<long long>(INT_MAX) + 1) { overflow = true; value = 0; }
+    });
+    if (status != ParseStatus::Ok) return status;
+    if (digits == 0 || p != end) return ParseStatus::InvalidNumber;
+    if (negative) value = -value;
+    if (overflow || value > INT_MAX || value < INT_MIN) return ParseStatus::OutOfRange;
+    out = static_cast<int>(value);
+    return ParseStatus::Ok;
+}
+
+ParseStatus NumberParser::parseCents(const char* data, size_t size, int64_t& out) {
+    // 整数部分不超过该值时乘以100再加上分不会溢出
+    static const int64_t MAX_YUAN = INT64_MAX / 100 - 1;
+    const char* p = data;
+    const char* end = data + size;
+    trim(p, end);
+    if (p == end) return ParseStatus::Empty;
+
+    // 同时保留一份去掉千分位逗号的副本，带指数时交给 strtod
+    char plain[64];
+    size_t plainLength = 0;
+    auto keep = [&](char c) { if (plainLength < sizeof(plain) - 1) plain[plainLength] = c; ++plainLength; };
+
+    bool negative = false;
+    if (*p == '-' || *p == '+') { negative = (*p == '-'); keep(*p++); }
+
+    int64_t yuan = 0;
+    bool overflow = false;
+    size_t intDigits = 0;
+    ParseStatus status = scanGroupedDigits(p, end, intDigits, [&](char c) {
+        if (yuan > (MAX_YUAN - (c - '0')) / 10) overflow = true;
+        else yuan = yuan * 10 + (c - '0');
+        keep(c);
+    });
+    if (status != ParseStatus::Ok) return status;
+
+    // 小数部分：前两位是分，第三位决定四舍五入，之后的位只校验
+    int64_t fraction = 0;
+    size_t fractionDigits = 0;
+    bool roundUp = false;
+    if (p < end && *p == '.') {
+        keep(*p++);
+        for (; p < end && isDigit(*p); ++p) {
+            if (fractionDigits < 2) fraction = fraction * 10 + (*p - '0');
+            else if (fractionDigits == 2) roundUp = (*p >= '5');
+            keep(*p);
+            ++fractionDigits;
+        }
+    }
+    if (intDigits + fractionDigits == 0) return ParseStatus::InvalidNumber;
+    if (fractionDigits == 1) fraction *= 10;
+
+    if (p == end) {
+        if (overflow) return ParseStatus::OutOfRange;
+        int64_t cents = yuan * 100 + fraction + (roundUp ? 1 : 0);
+        out = negative ? -cents : cents;
+        return ParseStatus::Ok;
+    }
+
+    // 指数形式（如 1.5e3）很少见，换成 double 计算后舍入到分
+    if (*p != 'e' && *p != 'E') return ParseStatus::InvalidNumber;
+    keep(*p++);
+    if (p < end && (*p == '-' || *p == '+')) keep(*p++);
+    if (p == end || !isDigit(*p)) return ParseStatus::InvalidNumber;
+    while (p < end && isDigit(*p)) keep(*p++);
+    if (p != end) return ParseStatus::InvalidNumber;
+    if (plainLength >= sizeof(plain)) return ParseStatus::OutOfRange;
+
+    plain[plainLength] = '\0';
+    double value = std::strtod(plain, nullptr) * 100.0;
+    if (!std::isfinite(value) || std::fabs(value) >= static_cast<double>(MAX_YUAN) * 100.0) return ParseStatus::OutOfRange;
+    out = static_cast<int64_t>(std::llround(value));
+    return ParseStatus::Ok;
+}
+
+const char* NumberParser::describe(ParseStatus status) {
+    switch (status) {
+        case ParseStatus::Ok: return "正常";
+        case ParseStatus::Empty: return "字段为空";
+        case ParseStatus::InvalidNumber: return "不是有效的数字";
+        case ParseStatus::BadGrouping: return "千分位分组不正确";
+        case ParseStatus::OutOfRange: return "数值超出范围";
+        case ParseStatus::InvalidDate: return "不是有效的日期";
+        case ParseStatus::MissingFields: return "字段数不足";
+        case ParseStatus::TooManyStrings: return "不同的文本过多，超出字典容量";
+    }
+    return "未知错误";
+}
@@ -0,0 +1,120 @@
+#include "PersistenceWorker.h"
+#include "AtomicFile.h"
+#include <chrono>
+
+PersistenceWorker::PersistenceWorker(unsigned windowMs)
+    : windowMs(windowMs), enqueuedCount(0), persistedCount(0), attemptCount(0),
+      flushRequested(false), stopping(false), failed(false) {
+    if (windowMs > 0) worker = std::thread(&PersistenceWorker::run, this);
+}
+
+PersistenceWorker::~PersistenceWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+bool PersistenceWorker::append(const std::string& path, const std::string& entry) {
+    if (windowMs == 0) return AtomicFile::appendSynced(path, entry.data(), entry.size());
+
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = pending.begin();
+    while (it != pending.end() && it->path != path) ++it;
+    if (it == pending.end()) {
+        pending.push_back(PendingFile());
+        pending.back().path = path;
+        it = pending.end() - 1;
+    }
+    it->buffer += entry;
+    ++it->entries;
+    ++enqueuedCount;
+    lock.unlock();
+    wake.notify_one();
+    return true;
+}
+
+bool PersistenceWorker::flush() {
+    if (windowMs == 0) return true;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    uint64_t target = enqueuedCount;
+    uint64_t attempts = attemptCount;
+    if (persistedCount < target) {
+        flushRequested = true;
+        wake.notify_one();
+        // 等到全部落盘，或者本次请求之后又有一次写入失败
+        persisted.wait(lock, [this, target, attempts]() {
+            return persistedCount >= target || (failed && attemptCount > attempts);
+        });
+    }
+    return persistedCount >= target;
+}
+
+unsigned PersistenceWorker::getWindowMs() const {
+    return windowMs;
+}
+
+void PersistenceWorker::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this]() { return stopping || !pending.empty(); });
+        if (pending.empty()) break;
+
+        // 收到第一条（或上次写入失败）后等待一个窗口，让连续的修改合并成一次写入
+        if (!flushRequested && !stopping) {
+            wake.wait_for(lock, std::chrono::milliseconds(windowMs),
+                          [this]() { return flushRequested || stopping; });
+        }
+        std::vector<PendingFile> batch;
+        batch.swap(pending);
+        flushRequested = false;
+
+        lock.unlock();
+        uint64_t written = 0;
+        std::vector<PendingFile> unwritten = writeBatch(batch, written);
+        lock.lock();
+
+        failed = !unwritten.empty();
+        requeue(unwritten);
+        persistedCount += written;
+        ++attemptCount;
+        persisted.notify_all();
+        // 退出时仍然写不进去就放弃，避免析构无限重试
+        if (failed && stopping) break;
+    }
+}
+
+void PersistenceWorker::requeue(std::vector<PendingFile>& unwritten) {
+    for (auto& file : unwritten) {
+        auto it = pending.begin();
+        while (it != pending.end() && it->path != file.path) ++it;
+        if (it == pending.end()) {
+            pending.insert(pending.begin(), std::move(file));
+        } else {
+            it->buffer.insert(0, file.buffer);
+            it->entries += file.entries;
+        }
+    }
+}
+
+std::vector<PersistenceWorker::PendingFile> PersistenceWorker::writeBatch(const std::vector<PendingFile>& batch,
+                                                                          uint64_t& writtenEntries) {
+    std::vector<PendingFile> unwritten;
+    for (const auto& file : batch) {
+        size_t written = 0;
+        if (AtomicFile::appendSynced(file.path, file.buffer.data(), file.buffer.size(), &written)) {
+            writtenEntries += file.entries;
+            continue;
+        }
+        // 已写入的部分不再重写；全部写入但刷盘失败时剩余内容为空，重试时只刷盘
+        PendingFile rest;
+        rest.path = file.path;
+        rest.buffer = file.buffer.substr(written);
+        rest.entries = file.entries;
+        unwritten.push_back(std::move(rest));
+    }
+    return unwritten;
+}
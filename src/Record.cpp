@@ -1,13 +1,14 @@
 #include "Record.h"
 
 // 默认构造函数
-Record::Record() : id(0), date(""), amount(0.0), category(""), description("") {
+Record::Record() : id(0), date(), amount(), category(StringDictionary::categories().getEmptyId()), description("") {
 }
 
 // 带参数构造函数
-Record::Record(int id, const std::string& date, double amount,
+Record::Record(int id, Date date, Money amount,
                const std::string& category, const std::string& description)
-    : id(id), date(date), amount(amount), category(category), description(description) {
+    : id(id), date(date), amount(amount), category(StringDictionary::categories().intern(category)),
+      description(description) {
 }
 
 // Getters
@@ -15,15 +16,19 @@ int Record::getId() const {
     return id;
 }
 
-std::string Record::getDate() const {
+Date Record::getDate() const {
     return date;
 }
 
-double Record::getAmount() const {
+Money Record::getAmount() const {
     return amount;
 }
 
-std::string Record::getCategory() const {
+const std::string& Record::getCategory() const {
+    return StringDictionary::categories().text(category);
+}
+
+uint32_t Record::getCategoryId() const {
     return category;
 }
 
@@ -36,16 +41,20 @@ void Record::setId(int id) {
     this->id = id;
 }
 
-void Record::setDate(const std::string& date) {
+void Record::setDate(Date date) {
     this->date = date;
 }
 
-void Record::setAmount(double amount) {
+void Record::setAmount(Money amount) {
     this->amount = amount;
 }
 
 void Record::setCategory(const std::string& category) {
-    this->category = category;
+    this->category = StringDictionary::categories().intern(category);
+}
+
+void Record::setCategoryId(uint32_t categoryId) {
+    this->category = categoryId;
 }
 
 void Record::setDescription(const std::string& description) {
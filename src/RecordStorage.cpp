@@ -1,139 +1,633 @@
 #include "RecordStorage.h"
+#include "MappedFile.h"
+#include "CsvReader.h"
+#include "LedgerSnapshot.h"
+#include "AtomicFile.h"
 #include <fstream>
-#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include <iterator>
+#include <map>
+#include <set>
 
 #ifdef _WIN32
 #include <direct.h>
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
 #define MKDIR(dir) _mkdir(dir)
 #else
 #include <sys/stat.h>
+#include <dirent.h>
 #define MKDIR(dir) mkdir(dir, 0755)
 #endif
 
-RecordStorage::RecordStorage(const std::string& incomeFile, const std::string& expenseFile)
-    : incomeFilePath(incomeFile), expenseFilePath(expenseFile), nextIncomeId(1), nextExpenseId(1) {
-    ensureDataDirectory();
-}
+static const char* const JOURNAL_SUFFIX = ".journal";
+static const char* const COMPACTING_SUFFIX = ".compacting";
+static const char* const INCOME_HEADER = "id,date,amount,category,source,description";
+static const char* const EXPENSE_HEADER = "id,date,amount,category,payee,description";
+// 日期不是 YYYY-MM-DD 形式的记录统一放入该分区
+static const char* const UNDATED_PARTITION = "undated";
+// 分区目录中的迁移标记：全部月份写出后才创建，此后该表只从分区加载
+static const char* const PARTITIONED_MARKER = ".partitioned";
+// 迁移完成后旧的单文件改为该后缀留作备份
+static const char* const MIGRATED_SUFFIX = ".migrated";
 
-bool RecordStorage::ensureDataDirectory() const {
-    size_t pos = incomeFilePath.find_last_of("/\\");
-    if (pos != std::string::npos) {
-        std::string dir = incomeFilePath.substr(0, pos);
-        MKDIR(dir.c_str());
+// 读取一条完整的CSV记录（引号内的换行属于字段内容）
+static bool readCSVRecord(std::istream& in, std::string& record) {
+    if (!std::getline(in, record)) return false;
+    while (std::count(record.begin(), record.end(), '"') % 2 != 0) {
+        std::string next;
+        if (!std::getline(in, next)) break;
+        record += '\n';
+        record += next;
     }
     return true;
 }
 
-std::string RecordStorage::escapeCSV(const std::string& field) const {
-    bool needsQuotes = false;
-    std::string result;
-    for (char c : field) {
-        if (c == '"') { result += "\"\""; needsQuotes = true; }
-        else if (c == ',' || c == '\n' || c == '\r') { result += c; needsQuotes = true; }
-        else { result += c; }
-    }
-    return needsQuotes ? "\"" + result + "\"" : result;
+static long fileSize(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file.is_open() ? static_cast<long>(file.tellg()) : 0;
+}
+
+static bool fileExists(const std::string& path) {
+    std::ifstream file(path);
+    return file.is_open();
 }
 
-std::string RecordStorage::unescapeCSV(const std::string& field) const {
-    if (field.empty()) return field;
-    std::string result = field;
-    if (result.length() >= 2 && result.front() == '"' && result.back() == '"') {
-        result = result.substr(1, result.length() - 2);
+// 记录所属的月份分区名，如 2024-01
+static std::string monthKey(Date date) {
+    return date.isEmpty() ? std::string(UNDATED_PARTITION) : Date::formatYearMonth(date.getYearMonth());
+}
+
+// 数据文件 data/expense.csv 对应的分区目录 data/expense
+static std::string partitionDirOf(const std::string& filePath) {
+    size_t dot = filePath.find_last_of('.');
+    size_t slash = filePath.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return filePath + ".d";
+    return filePath.substr(0, dot);
+}
+
+static std::string partitionPath(const std::string& dir, const std::string& month) {
+    return dir + "/" + month + ".csv";
+}
+
+// 该表是否已完成按月分区的迁移；没有标记时即使分区目录中有文件（迁移中断）也仍以单文件为准
+static bool isPartitioned(const std::string& filePath) {
+    return fileExists(partitionDirOf(filePath) + "/" + PARTITIONED_MARKER);
+}
+
+// 实际使用的布局：迁移完成后即使配置改回单文件也继续使用分区，不会读到迁移前的旧文件
+static StorageLayout effectiveLayout(const std::string& filePath, StorageLayout configured) {
+    return isPartitioned(filePath) ? StorageLayout::MonthPartitioned : configured;
+}
+
+// 列出目录下以 suffix 结尾的文件名（去掉后缀，按名称排序）
+static std::vector<std::string> listFiles(const std::string& dir, const std::string& suffix) {
+    std::vector<std::string> names;
+#ifdef _WIN32
+    WIN32_FIND_DATAA entry;
+    HANDLE handle = FindFirstFileA((dir + "\\*" + suffix).c_str(), &entry);
+    if (handle != INVALID_HANDLE_VALUE) {
+        do {
+            std::string name = entry.cFileName;
+            if (!(entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && name.size() > suffix.size() &&
+                name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+                names.push_back(name.substr(0, name.size() - suffix.size()));
+            }
+        } while (FindNextFileA(handle, &entry));
+        FindClose(handle);
     }
-    std::string unescaped;
-    for (size_t i = 0; i < result.length(); ++i) {
-        if (result[i] == '"' && i + 1 < result.length() && result[i + 1] == '"') {
-            unescaped += '"'; ++i;
-        } else { unescaped += result[i]; }
+#else
+    DIR* handle = opendir(dir.c_str());
+    if (handle) {
+        while (struct dirent* entry = readdir(handle)) {
+            std::string name = entry->d_name;
+            if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+                names.push_back(name.substr(0, name.size() - suffix.size()));
+            }
+        }
+        closedir(handle);
     }
-    return unescaped;
+#endif
+    std::sort(names.begin(), names.end());
+    return names;
 }
 
-std::vector<std::string> RecordStorage::splitCSV(const std::string& line) const {
-    std::vector<std::string> fields;
-    std::string field;
+// 列出分区目录下的全部月份
+static std::vector<std::string> listPartitions(const std::string& dir) {
+    return listFiles(dir, ".csv");
+}
+
+// 截掉日志末尾写了一半的条目（进程在追加时被杀），返回是否做了截断。
+// 完整条目以引号之外的换行结尾
+static bool truncateTornJournal(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    size_t valid = 0;
     bool inQuotes = false;
-    for (size_t i = 0; i < line.length(); ++i) {
-        char c = line[i];
-        if (c == '"') {
-            if (inQuotes && i + 1 < line.length() && line[i + 1] == '"') { field += '"'; ++i; }
-            else { inQuotes = !inQuotes; field += c; }
-        } else if (c == ',' && !inQuotes) { fields.push_back(field); field.clear(); }
-        else { field += c; }
+    for (size_t i = 0; i < content.size(); ++i) {
+        if (content[i] == '"') inQuotes = !inQuotes;
+        else if (content[i] == '\n' && !inQuotes) valid = i + 1;
     }
-    fields.push_back(field);
-    return fields;
+    if (valid == content.size()) return false;
+    return AtomicFile::write(path, content.data(), valid);
 }
 
-std::vector<IncomeRecord> RecordStorage::loadIncomeRecords() {
-    std::vector<IncomeRecord> records;
-    std::ifstream file(incomeFilePath);
-    if (!file.is_open()) return records;
-    
+// 在已加载的记录上按顺序重放日志：U 为按ID覆盖或追加，D 为按ID删除
+template <typename T>
+static void replayJournal(const std::string& path, std::vector<T>& records) {
+    std::ifstream file(path);
+    if (!file.is_open()) return;
+
+    std::unordered_map<int, size_t> index;
+    for (size_t i = 0; i < records.size(); ++i) index[records[i].getId()] = i;
+    std::vector<bool> removed(records.size(), false);
+
     std::string line;
-    bool isFirstLine = true;
-    int maxId = 0;
-    
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        if (isFirstLine) { isFirstLine = false; if (line.find("id,") == 0) continue; }
-        IncomeRecord record;
-        if (record.fromCSV(line)) {
-            records.push_back(record);
-            if (record.getId() > maxId) maxId = record.getId();
+    while (readCSVRecord(file, line)) {
+        if (line.size() < 3 || line[1] != ',') continue;  // 空行或被截断的尾行
+        if (line[0] == static_cast<char>(JournalOp::Upsert)) {
+            T record;
+            if (!record.fromCSV(line.substr(2))) continue;
+            auto it = index.find(record.getId());
+            if (it != index.end()) {
+                records[it->second] = record;
+            } else {
+                index[record.getId()] = records.size();
+                records.push_back(record);
+                removed.push_back(false);
+            }
+        } else if (line[0] == static_cast<char>(JournalOp::Delete)) {
+            // 删除项可能只有ID（旧格式），也可能是完整记录，开头都是ID
+            auto it = index.find(std::atoi(line.c_str() + 2));
+            if (it != index.end()) { removed[it->second] = true; index.erase(it); }
         }
     }
-    file.close();
-    nextIncomeId = maxId + 1;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (!removed[i]) records[kept++] = records[i];
+    }
+    records.resize(kept);
+}
+
+// 收集日志中涉及的月份：新增、修改和删除都会改动记录所在月份的分区
+template <typename T>
+static void collectJournalMonths(const std::string& path, std::set<std::string>& months) {
+    std::ifstream file(path);
+    if (!file.is_open()) return;
+    std::string line;
+    while (readCSVRecord(file, line)) {
+        if (line.size() < 3 || line[1] != ',') continue;
+        T record;
+        if (record.fromCSV(line.substr(2))) months.insert(monthKey(record.getDate()));
+    }
+}
+
+// 某一块解析时跳过的行，行号相对于块的起点
+struct ChunkIssues {
+    std::vector<LoadIssue> issues;
+    size_t skipped = 0;
+    size_t lines = 0;   // 块内的换行数，用于换算后续块的行号
+};
+
+// 解析 [begin, end) 内的记录；只有文件的第一块需要跳过表头。
+// 无法解析的行不抛异常，记入 result（最多保留 MAX_REPORTED_ISSUES 条明细）
+template <typename T>
+static void parseRecords(const char* begin, const char* end, bool atFileStart, std::vector<T>& records,
+                         ChunkIssues& result) {
+    // 按行数预留空间，避免记录对象在扩容时反复搬移
+    size_t lines = 0;
+    for (const char* p = begin; (p = static_cast<const char*>(std::memchr(p, '\n', end - p))) != nullptr; ++p) ++lines;
+    records.reserve(records.size() + lines + 1);
+    result.lines = lines;
+
+    CsvReader reader(begin, end);
+    CsvField fields[CsvReader::MAX_FIELDS];
+    size_t count = 0;
+    bool isFirstRecord = atFileStart;
+    while (reader.next(fields, count)) {
+        if (isFirstRecord) {
+            isFirstRecord = false;
+            if (count > 1 && fields[0].equals("id")) continue;
+        }
+        records.emplace_back();
+        size_t column = 0;
+        ParseStatus status = records.back().fromFields(fields, count, &column);
+        if (status == ParseStatus::Ok) continue;
+        records.pop_back();
+        if (result.issues.size() < RecordStorage::MAX_REPORTED_ISSUES) {
+            LoadIssue issue;
+            issue.line = reader.line();
+            issue.column = column + 1;
+            issue.status = status;
+            result.issues.push_back(issue);
+        }
+        ++result.skipped;
+    }
+}
+
+// 把各块的问题换算成文件内的行号后并入 report
+static void mergeIssues(const std::string& path, std::vector<ChunkIssues>& chunks, LoadReport& report) {
+    size_t lineOffset = 0;
+    for (auto& chunk : chunks) {
+        for (auto& issue : chunk.issues) {
+            if (report.issues.size() >= RecordStorage::MAX_REPORTED_ISSUES) break;
+            issue.file = path;
+            issue.line += lineOffset;
+            report.issues.push_back(issue);
+        }
+        report.skippedRows += chunk.skipped;
+        lineOffset += chunk.lines;
+    }
+}
+
+// 在内存映射的文件上加载记录；大文件按记录边界切块，多线程解析后按块顺序合并
+template <typename T>
+static void loadMappedRecords(const std::string& path, std::vector<T>& records, unsigned threads,
+                              LoadReport& report) {
+    MappedFile file(path);
+    if (!file.isOpen() || file.size() == 0) return;
+
+    size_t parts = std::min<size_t>(threads, file.size() / RecordStorage::PARALLEL_CHUNK_BYTES);
+    if (parts <= 1) {
+        std::vector<ChunkIssues> issues(1);
+        parseRecords(file.data(), file.end(), true, records, issues[0]);
+        mergeIssues(path, issues, report);
+        return;
+    }
+
+    std::vector<const char*> bounds = CsvReader::splitRecords(file.data(), file.end(), parts);
+    std::vector<std::vector<T>> chunks(bounds.size() - 1);
+    std::vector<ChunkIssues> issues(chunks.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        workers.emplace_back([&bounds, &chunks, &issues, i]() {
+            parseRecords(bounds[i], bounds[i + 1], false, chunks[i], issues[i]);
+        });
+    }
+    parseRecords(bounds[0], bounds[1], true, chunks[0], issues[0]);
+    for (auto& worker : workers) worker.join();
+    mergeIssues(path, issues, report);
+
+    size_t total = records.size();
+    for (const auto& chunk : chunks) total += chunk.size();
+    records.reserve(total);
+    for (auto& chunk : chunks) {
+        std::move(chunk.begin(), chunk.end(), std::back_inserter(records));
+        std::vector<T>().swap(chunk);
+    }
+}
+
+// 在内存中拼好整个CSV文件，一次写入临时文件后原子替换
+template <typename T>
+static bool writeRecordFile(const std::string& path, const char* header, const std::vector<const T*>& records) {
+    std::string content;
+    content.reserve(64 * (records.size() + 1));
+    content += header;
+    content += '\n';
+    for (const T* record : records) {
+        record->appendCSV(content);
+        content += '\n';
+    }
+    return AtomicFile::write(path, content);
+}
+
+// 写回基础文件。按月分区时只重写 months 中的月份（为空的月份删除分区文件），
+// writeAll 为 true 时重写全部月份并删除已不存在的分区
+template <typename T>
+static bool writeBaseRecords(const std::string& filePath, StorageLayout layout, const char* header,
+                             const std::vector<T>& records, const std::set<std::string>& months, bool writeAll) {
+    if (layout == StorageLayout::SingleFile) {
+        std::vector<const T*> all;
+        all.reserve(records.size());
+        for (const auto& record : records) all.push_back(&record);
+        return writeRecordFile(filePath, header, all);
+    }
+
+    std::string dir = partitionDirOf(filePath);
+    MKDIR(dir.c_str());
+    std::map<std::string, std::vector<const T*>> partitions;
+    if (writeAll) {
+        for (const auto& month : listPartitions(dir)) partitions[month];
+    } else {
+        for (const auto& month : months) partitions[month];
+    }
+    // 先按整数年月键分组，每个月份只格式化一次分区名
+    std::map<uint32_t, std::vector<const T*>> byMonth;
+    for (const auto& record : records) byMonth[record.getDate().getYearMonth()].push_back(&record);
+    for (auto& group : byMonth) {
+        std::string month = monthKey(group.second.front()->getDate());
+        auto it = partitions.find(month);
+        if (it != partitions.end()) it->second.swap(group.second);
+        else if (writeAll) partitions[month].swap(group.second);
+    }
+    for (const auto& partition : partitions) {
+        std::string path = partitionPath(dir, partition.first);
+        if (partition.second.empty()) std::remove(path.c_str());
+        else if (!writeRecordFile(path, header, partition.second)) return false;
+    }
+
+    // 首次迁移：全部月份写出后才创建标记，再把旧的单文件改名；标记写出前中断时下次仍从单文件重新迁移
+    if (!isPartitioned(filePath)) {
+        if (!AtomicFile::write(dir + "/" + PARTITIONED_MARKER, std::string("month\n"))) return false;
+        std::string backup = filePath + MIGRATED_SUFFIX;
+        std::remove(backup.c_str());
+        std::rename(filePath.c_str(), backup.c_str());
+    }
+    return true;
+}
+
+// 加载基础文件。迁移完成后依次加载各月份文件（可能一个都没有），否则从单文件加载
+template <typename T>
+static void loadBaseRecords(const std::string& filePath, unsigned threads, std::vector<T>& records,
+                            LoadReport& report) {
+    if (!isPartitioned(filePath)) {
+        loadMappedRecords(filePath, records, threads, report);
+        return;
+    }
+    std::string dir = partitionDirOf(filePath);
+    for (const auto& month : listPartitions(dir)) loadMappedRecords(partitionPath(dir, month), records, threads, report);
+}
+
+// 按月份顺序混合全部分区文件的标记，作为快照一致性标记
+static FileStamp partitionStamp(const std::string& dir) {
+    FileStamp stamp;
+    for (const auto& month : listPartitions(dir)) stamp.combine(month, FileStamp::of(partitionPath(dir, month)));
+    return stamp;
+}
+
+template <typename T>
+static int maxRecordId(const std::vector<T>& records) {
+    int maxId = 0;
+    for (const auto& r : records) if (r.getId() > maxId) maxId = r.getId();
+    return maxId;
+}
+
+RecordStorage::RecordStorage(const std::string& incomeFile, const std::string& expenseFile,
+                             const StorageOptions& options)
+    : incomeFilePath(incomeFile), expenseFilePath(expenseFile), options(options), nextIncomeId(1), nextExpenseId(1),
+      journalWriter(options.durabilityWindowMs), incomeJournalBytes(0), expenseJournalBytes(0) {
+    size_t pos = incomeFilePath.find_last_of("/\\");
+    snapshotFilePath = (pos == std::string::npos ? std::string() : incomeFilePath.substr(0, pos + 1)) + "ledger.ffm";
+    ensureDataDirectory();
+}
+
+RecordStorage::~RecordStorage() {
+    waitForCompaction();
+    flushJournals();
+}
+
+bool RecordStorage::ensureDataDirectory() const {
+    size_t pos = incomeFilePath.find_last_of("/\\");
+    if (pos != std::string::npos) {
+        std::string dir = incomeFilePath.substr(0, pos);
+        MKDIR(dir.c_str());
+    }
+    return true;
+}
+
+unsigned RecordStorage::getLoadThreads() const {
+    if (options.loadThreads > 0) return options.loadThreads;
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores > 0 ? cores : 1;
+}
+
+std::vector<IncomeRecord> RecordStorage::loadIncomeRecords() {
+    std::vector<IncomeRecord> records;
+    incomeReport = LoadReport();
+    loadBaseRecords(incomeFilePath, getLoadThreads(), records, incomeReport);
+    finishIncomeLoad(records);
     return records;
 }
 
+void RecordStorage::finishIncomeLoad(std::vector<IncomeRecord>& records) {
+    std::string journalPath = getIncomeJournalPath();
+    replayJournal(journalPath + COMPACTING_SUFFIX, records);
+    replayJournal(journalPath, records);
+    incomeJournalBytes = fileSize(journalPath);
+    nextIncomeId = maxRecordId(records) + 1;
+}
+
 bool RecordStorage::saveIncomeRecords(const std::vector<IncomeRecord>& records) {
     ensureDataDirectory();
-    std::ofstream file(incomeFilePath);
-    if (!file.is_open()) return false;
-    file << "id,date,amount,category,source,description" << std::endl;
-    for (const auto& record : records) { file << record.toCSV() << std::endl; }
-    file.close();
-    return true;
+    return writeBaseRecords(incomeFilePath, effectiveLayout(incomeFilePath, options.layout), INCOME_HEADER, records,
+                            std::set<std::string>(), true);
+}
+
+bool RecordStorage::writeIncomeBase(const std::vector<IncomeRecord>& records,
+                                    const std::vector<std::string>& journalPaths) const {
+    ensureDataDirectory();
+    // 尚未迁移（首次从单文件写出分区）时需要写出全部月份
+    StorageLayout layout = effectiveLayout(incomeFilePath, options.layout);
+    bool writeAll = layout == StorageLayout::SingleFile || !isPartitioned(incomeFilePath);
+    std::set<std::string> months;
+    if (!writeAll) {
+        for (const auto& path : journalPaths) collectJournalMonths<IncomeRecord>(path, months);
+    }
+    return writeBaseRecords(incomeFilePath, layout, INCOME_HEADER, records, months, writeAll);
+}
+
+bool RecordStorage::appendIncomeJournal(JournalOp op, const IncomeRecord& record) {
+    return appendJournal(getIncomeJournalPath(), incomeJournalBytes, op, record.toCSV());
 }
 
 int RecordStorage::getNextIncomeId() { return nextIncomeId++; }
 
 std::vector<ExpenseRecord> RecordStorage::loadExpenseRecords() {
     std::vector<ExpenseRecord> records;
-    std::ifstream file(expenseFilePath);
-    if (!file.is_open()) return records;
-    
-    std::string line;
-    bool isFirstLine = true;
-    int maxId = 0;
-    
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        if (isFirstLine) { isFirstLine = false; if (line.find("id,") == 0) continue; }
-        ExpenseRecord record;
-        if (record.fromCSV(line)) {
-            records.push_back(record);
-            if (record.getId() > maxId) maxId = record.getId();
-        }
-    }
-    file.close();
-    nextExpenseId = maxId + 1;
+    expenseReport = LoadReport();
+    loadBaseRecords(expenseFilePath, getLoadThreads(), records, expenseReport);
+    finishExpenseLoad(records);
     return records;
 }
 
+void RecordStorage::finishExpenseLoad(std::vector<ExpenseRecord>& records) {
+    std::string journalPath = getExpenseJournalPath();
+    replayJournal(journalPath + COMPACTING_SUFFIX, records);
+    replayJournal(journalPath, records);
+    expenseJournalBytes = fileSize(journalPath);
+    nextExpenseId = maxRecordId(records) + 1;
+}
+
 bool RecordStorage::saveExpenseRecords(const std::vector<ExpenseRecord>& records) {
     ensureDataDirectory();
-    std::ofstream file(expenseFilePath);
-    if (!file.is_open()) return false;
-    file << "id,date,amount,category,payee,description" << std::endl;
-    for (const auto& record : records) { file << record.toCSV() << std::endl; }
-    file.close();
-    return true;
+    return writeBaseRecords(expenseFilePath, effectiveLayout(expenseFilePath, options.layout), EXPENSE_HEADER, records,
+                            std::set<std::string>(), true);
+}
+
+bool RecordStorage::writeExpenseBase(const std::vector<ExpenseRecord>& records,
+                                     const std::vector<std::string>& journalPaths) const {
+    ensureDataDirectory();
+    StorageLayout layout = effectiveLayout(expenseFilePath, options.layout);
+    bool writeAll = layout == StorageLayout::SingleFile || !isPartitioned(expenseFilePath);
+    std::set<std::string> months;
+    if (!writeAll) {
+        for (const auto& path : journalPaths) collectJournalMonths<ExpenseRecord>(path, months);
+    }
+    return writeBaseRecords(expenseFilePath, layout, EXPENSE_HEADER, records, months, writeAll);
+}
+
+bool RecordStorage::appendExpenseJournal(JournalOp op, const ExpenseRecord& record) {
+    return appendJournal(getExpenseJournalPath(), expenseJournalBytes, op, record.toCSV());
 }
 
 int RecordStorage::getNextExpenseId() { return nextExpenseId++; }
+
+bool RecordStorage::appendJournal(const std::string& path, long& bytes, JournalOp op, const std::string& csv) {
+    std::string entry(1, static_cast<char>(op));
+    entry += ',';
+    entry += csv;
+    entry += '\n';
+    bytes += static_cast<long>(entry.size());
+    return journalWriter.append(path, entry);
+}
+
+bool RecordStorage::flushJournals() {
+    return journalWriter.flush();
+}
+
+bool RecordStorage::loadSnapshot(std::vector<IncomeRecord>& income, std::vector<ExpenseRecord>& expense) {
+    if (!LedgerSnapshot::read(snapshotFilePath, income, expense,
+                              incomeStamp(), expenseStamp())) {
+        income.clear();
+        expense.clear();
+        return false;
+    }
+    finishIncomeLoad(income);
+    finishExpenseLoad(expense);
+    return true;
+}
+
+bool RecordStorage::saveSnapshot(const std::vector<IncomeRecord>& income,
+                                 const std::vector<ExpenseRecord>& expense) const {
+    return LedgerSnapshot::write(snapshotFilePath, income, expense,
+                                 incomeStamp(), expenseStamp());
+}
+
+FileStamp RecordStorage::incomeStamp() const {
+    return isPartitioned(incomeFilePath) ? partitionStamp(getIncomePartitionDir()) : FileStamp::of(incomeFilePath);
+}
+
+FileStamp RecordStorage::expenseStamp() const {
+    return isPartitioned(expenseFilePath) ? partitionStamp(getExpensePartitionDir()) : FileStamp::of(expenseFilePath);
+}
+
+bool RecordStorage::needsCompaction() const {
+    return incomeJournalBytes + expenseJournalBytes >= JOURNAL_COMPACT_THRESHOLD;
+}
+
+bool RecordStorage::hasPendingCompaction() const {
+    if (fileExists(getIncomeJournalPath() + COMPACTING_SUFFIX) ||
+        fileExists(getExpenseJournalPath() + COMPACTING_SUFFIX)) {
+        return true;
+    }
+    // 刚切换到按月分区、数据仍在旧的单文件中（尚无迁移标记）时，也需要写出一次分区
+    if (options.layout == StorageLayout::MonthPartitioned) {
+        return (!isPartitioned(incomeFilePath) && fileSize(incomeFilePath) > 0) ||
+               (!isPartitioned(expenseFilePath) && fileSize(expenseFilePath) > 0);
+    }
+    return false;
+}
+
+void RecordStorage::compactInBackground(RecordColumns<IncomeRecord> income,
+                                        RecordColumns<ExpenseRecord> expense) {
+    waitForCompaction();
+    // 残留的压缩日志说明上次压缩未完成，直接同步落盘
+    if (hasPendingCompaction()) { checkpoint(income.toRecords(), expense.toRecords()); return; }
+
+    // 先把当前日志改名冻结，新的修改写入新日志；后台写完基础文件后再删除冻结的日志
+    flushJournals();
+    std::string incomeJournalPath = getIncomeJournalPath();
+    std::string expenseJournalPath = getExpenseJournalPath();
+    std::rename(incomeJournalPath.c_str(), (incomeJournalPath + COMPACTING_SUFFIX).c_str());
+    std::rename(expenseJournalPath.c_str(), (expenseJournalPath + COMPACTING_SUFFIX).c_str());
+    incomeJournalBytes = 0;
+    expenseJournalBytes = 0;
+
+    // 列数据移入线程，记录对象在后台组装，调用方只付出列拷贝的开销
+    compactionThread = std::thread([this, incomeColumns = std::move(income), expenseColumns = std::move(expense),
+                                    incomeJournalPath, expenseJournalPath]() {
+        std::vector<IncomeRecord> incomeRecords = incomeColumns.toRecords();
+        std::vector<ExpenseRecord> expenseRecords = expenseColumns.toRecords();
+        if (writeIncomeBase(incomeRecords, {incomeJournalPath + COMPACTING_SUFFIX}) &&
+            writeExpenseBase(expenseRecords, {expenseJournalPath + COMPACTING_SUFFIX})) {
+            saveSnapshot(incomeRecords, expenseRecords);
+            std::remove((incomeJournalPath + COMPACTING_SUFFIX).c_str());
+            std::remove((expenseJournalPath + COMPACTING_SUFFIX).c_str());
+        }
+    });
+}
+
+void RecordStorage::waitForCompaction() {
+    if (compactionThread.joinable()) compactionThread.join();
+}
+
+bool RecordStorage::checkpoint(const std::vector<IncomeRecord>& income,
+                               const std::vector<ExpenseRecord>& expense) {
+    waitForCompaction();
+    flushJournals();
+    std::string incomeJournalPath = getIncomeJournalPath();
+    std::string expenseJournalPath = getExpenseJournalPath();
+    if (!writeIncomeBase(income, {incomeJournalPath + COMPACTING_SUFFIX, incomeJournalPath}) ||
+        !writeExpenseBase(expense, {expenseJournalPath + COMPACTING_SUFFIX, expenseJournalPath})) {
+        return false;
+    }
+    saveSnapshot(income, expense);
+    for (const std::string& path : {incomeJournalPath, expenseJournalPath}) {
+        std::remove((path + COMPACTING_SUFFIX).c_str());
+        std::remove(path.c_str());
+    }
+    incomeJournalBytes = 0;
+    expenseJournalBytes = 0;
+    return true;
+}
+
+bool RecordStorage::recoverInterruptedWrites() {
+    waitForCompaction();
+    bool recovered = false;
+    // 残留的临时文件说明改名前就中断了，原文件仍完整，直接丢弃
+    for (const std::string& path : {incomeFilePath, expenseFilePath, snapshotFilePath,
+                                    getIncomeJournalPath(), getExpenseJournalPath()}) {
+        if (AtomicFile::recover(path)) recovered = true;
+    }
+    for (const std::string& dir : {getIncomePartitionDir(), getExpensePartitionDir()}) {
+        for (const auto& name : listFiles(dir, AtomicFile::TEMP_SUFFIX)) {
+            if (std::remove((dir + "/" + name + AtomicFile::TEMP_SUFFIX).c_str()) == 0) recovered = true;
+        }
+    }
+    // 日志是追加写入的，只可能在末尾留下半条
+    flushJournals();
+    for (const std::string& path : {getIncomeJournalPath(), getExpenseJournalPath()}) {
+        if (truncateTornJournal(path)) recovered = true;
+        if (truncateTornJournal(path + COMPACTING_SUFFIX)) recovered = true;
+    }
+    return recovered;
+}
+
+std::vector<LoadIssue> RecordStorage::getLoadIssues() const {
+    std::vector<LoadIssue> issues = incomeReport.issues;
+    issues.insert(issues.end(), expenseReport.issues.begin(), expenseReport.issues.end());
+    return issues;
+}
+
+size_t RecordStorage::getSkippedRowCount() const {
+    return incomeReport.skippedRows + expenseReport.skippedRows;
+}
+
 std::string RecordStorage::getIncomeFilePath() const { return incomeFilePath; }
 std::string RecordStorage::getExpenseFilePath() const { return expenseFilePath; }
+std::string RecordStorage::getIncomeJournalPath() const { return incomeFilePath + JOURNAL_SUFFIX; }
+std::string RecordStorage::getExpenseJournalPath() const { return expenseFilePath + JOURNAL_SUFFIX; }
+std::string RecordStorage::getSnapshotFilePath() const { return snapshotFilePath; }
+std::string RecordStorage::getIncomePartitionDir() const { return partitionDirOf(incomeFilePath); }
+std::string RecordStorage::getExpensePartitionDir() const { return partitionDirOf(expenseFilePath); }
+StorageLayout RecordStorage::getLayout() const { return options.layout; }
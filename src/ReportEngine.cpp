@@ -0,0 +1,155 @@
+#include "ReportEngine.h"
+#include "StringDictionary.h"
+#include "ThreadPool.h"
+#include "SimdKernels.h"
+#include <algorithm>
+
+ReportEngine::ReportEngine(const FinanceManager& mgr) : manager(mgr) {}
+
+// 由按分类 ID 分组的结果生成分类汇总，按金额从大到小、同额按名称排序
+static void fillCategories(LedgerReport& report, const std::vector<LedgerTotals::Bucket>& buckets) {
+    const StringDictionary& categories = StringDictionary::categories();
+    report.categories.clear();
+    for (uint32_t id = 0; id < buckets.size(); ++id) {
+        if (buckets[id].count == 0) continue;
+        CategorySummary s; s.category = categories.text(id); s.total = buckets[id].getTotal(); s.percentage = CategorySummary::percentOf(s.total, report.total);
+        report.categories.push_back(s);
+    }
+    std::sort(report.categories.begin(), report.categories.end(), [](const CategorySummary& a, const CategorySummary& b) {
+        return a.total != b.total ? a.total > b.total : a.category < b.category;
+    });
+}
+
+// 整个账本：汇总由 FinanceManager 随修改同步维护，这里只做格式转换
+static LedgerReport fromTotals(const LedgerTotals& totals) {
+    LedgerReport report;
+    report.total = totals.getTotal();
+    report.count = totals.getCount();
+    for (const auto& p : totals.getMonths()) report.months.emplace_hint(report.months.end(), p.first, p.second.getTotal());
+    fillCategories(report, totals.getCategories());
+    return report;
+}
+
+namespace {
+
+// 一段记录的汇总，各线程各自累加，最后按分段顺序合并
+struct Accumulator {
+    int64_t total;
+    size_t count;
+    std::map<uint32_t, int64_t> months;
+    std::vector<LedgerTotals::Bucket> categories;
+
+    Accumulator() : total(0), count(0) {}
+
+    // 视图按日期有序，同一月份的记录相邻，月份只在切换时查找一次
+    template <typename T>
+    void add(const RecordView<T>& view) {
+        uint32_t currentMonth = 0;
+        int64_t monthCents = 0;
+        for (const auto& r : view) {
+            uint32_t month = r.getDate().getYearMonth();
+            int64_t cents = r.getAmount().getCents();
+            uint32_t category = r.getCategoryId();
+            if (month != currentMonth) {
+                if (currentMonth != 0) months[currentMonth] += monthCents;
+                currentMonth = month;
+                monthCents = 0;
+            }
+            monthCents += cents;
+            if (category >= categories.size()) categories.resize(category + 1);
+            categories[category].cents += cents;
+            ++categories[category].count;
+            total += cents;
+            ++count;
+        }
+        if (currentMonth != 0) months[currentMonth] += monthCents;
+    }
+
+    // 按日期过滤顺序扫描列 [begin, end)，月份和分类由向量化内核一并累加
+    template <typename T>
+    void addColumns(const RecordColumns<T>& columns, size_t begin, size_t end, uint32_t from, uint32_t to) {
+        std::vector<LedgerTotals::Bucket> monthBuckets(SimdKernels::monthSpan(from, to));
+        categories.resize(std::max<size_t>(categories.size(), StringDictionary::categories().size()));
+        SimdKernels::histogram(columns.dateColumn().data() + begin, columns.amountColumn().data() + begin,
+                               columns.categoryColumn().data() + begin, end - begin, from, to,
+                               monthBuckets.data(), categories.data());
+        for (size_t i = 0; i < monthBuckets.size(); ++i) {
+            if (monthBuckets[i].count == 0) continue;
+            months[from / 100 + static_cast<uint32_t>(i)] += monthBuckets[i].cents;
+            total += monthBuckets[i].cents;
+            count += monthBuckets[i].count;
+        }
+    }
+
+    void merge(const Accumulator& other) {
+        total += other.total;
+        count += other.count;
+        for (const auto& p : other.months) months[p.first] += p.second;
+        if (other.categories.size() > categories.size()) categories.resize(other.categories.size());
+        for (size_t id = 0; id < other.categories.size(); ++id) {
+            categories[id].cents += other.categories[id].cents;
+            categories[id].count += other.categories[id].count;
+        }
+    }
+};
+
+} // namespace
+
+// 日期区间：对区间内的记录只遍历一遍。区间占全部记录的比例较大时按日期过滤顺序扫描整列，
+// 否则沿日期索引遍历区间。记录较多时切成连续的几段交给共享线程池，
+// 每段得到自己的汇总后按分段顺序合并，结果与串行遍历相同
+template <typename T>
+static LedgerReport fromView(const RecordView<T>& view, const RecordColumns<T>& columns) {
+    ThreadPool& pool = ThreadPool::shared();
+    uint32_t from, to;
+    bool columnScan = view.preferColumnScan(from, to);
+    size_t count = columnScan ? columns.size() : view.size();
+    size_t parts = pool.partsFor(count);
+    std::vector<Accumulator> partial(parts);
+    pool.run(parts, [&](size_t i) {
+        size_t begin = count * i / parts;
+        size_t end = count * (i + 1) / parts;
+        if (columnScan) partial[i].addColumns(columns, begin, end, from, to);
+        else partial[i].add(parts == 1 ? view : view.page(begin, end - begin));
+    });
+    for (size_t i = 1; i < parts; ++i) partial[0].merge(partial[i]);
+
+    const Accumulator& result = partial[0];
+    LedgerReport report;
+    report.total = Money::fromCents(result.total);
+    report.count = result.count;
+    for (const auto& p : result.months) report.months.emplace_hint(report.months.end(), p.first, Money::fromCents(p.second));
+    fillCategories(report, result.categories);
+    return report;
+}
+
+// 按月份合并收入和支出，键的顺序即月份顺序，只在输出时格式化
+static void mergeMonths(FinanceReport& report) {
+    std::map<uint32_t, MonthlySummary> monthlyData;
+    for (const auto& p : report.income.months) monthlyData[p.first].totalIncome = p.second;
+    for (const auto& p : report.expense.months) monthlyData[p.first].totalExpense = p.second;
+
+    report.monthly.clear();
+    report.monthly.reserve(monthlyData.size());
+    for (auto& p : monthlyData) {
+        p.second.month = Date::formatYearMonth(p.first);
+        p.second.netBalance = p.second.totalIncome - p.second.totalExpense;
+        report.monthly.push_back(p.second);
+    }
+}
+
+FinanceReport ReportEngine::build() const {
+    FinanceReport report;
+    report.income = fromTotals(manager.getIncomeTotals());
+    report.expense = fromTotals(manager.getExpenseTotals());
+    mergeMonths(report);
+    return report;
+}
+
+FinanceReport ReportEngine::build(Date startDate, Date endDate) const {
+    FinanceReport report;
+    report.income = fromView(manager.viewIncomeByDateRange(startDate, endDate), manager.getIncomeColumns());
+    report.expense = fromView(manager.viewExpenseByDateRange(startDate, endDate), manager.getExpenseColumns());
+    mergeMonths(report);
+    return report;
+}
@@ -1,187 +1,165 @@
 #include "ReportGenerator.h"
 #include "DisplayHelper.h"
+#include "StringDictionary.h"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
-#include <map>
 
 ReportGenerator::ReportGenerator(FinanceManager& mgr) : manager(mgr) {}
 
-std::string ReportGenerator::extractMonth(const std::string& date) {
-    return date.length() >= 7 ? date.substr(0, 7) : "";
-}
-
-double ReportGenerator::calculateTotalFromRecords(const std::vector<IncomeRecord>& records) const {
-    double total = 0.0;
+Money ReportGenerator::calculateTotalFromRecords(const std::vector<IncomeRecord>& records) const {
+    Money total;
     for (const auto& r : records) total += r.getAmount();
     return total;
 }
 
-double ReportGenerator::calculateTotalFromRecords(const std::vector<ExpenseRecord>& records) const {
-    double total = 0.0;
+Money ReportGenerator::calculateTotalFromRecords(const std::vector<ExpenseRecord>& records) const {
+    Money total;
     for (const auto& r : records) total += r.getAmount();
     return total;
 }
 
 void ReportGenerator::printAllIncomeRecords() {
     DisplayHelper::printSubHeader("所有收入记录");
-    auto records = manager.getAllIncome();
+    auto records = manager.viewIncome();
     if (records.empty()) { DisplayHelper::printInfo("暂无收入记录"); return; }
     
     std::vector<std::string> headers = {"ID", "日期", "金额", "分类", "来源", "描述"};
     std::vector<int> widths = {6, 12, 14, 10, 12, 20};
     DisplayHelper::printTableHeader(headers, widths);
     
-    double total = 0.0;
+    Money total;
     for (const auto& r : records) {
-        std::vector<std::string> row = {std::to_string(r.getId()), r.getDate(), DisplayHelper::formatAmount(r.getAmount()), r.getCategory(), r.getSource(), r.getDescription()};
+        std::vector<std::string> row = {std::to_string(r.getId()), r.getDate().toString(), DisplayHelper::formatAmount(r.getAmount()), r.getCategory(), r.getParty(), r.getDescription()};
         DisplayHelper::printTableRow(row, widths);
         total += r.getAmount();
     }
-    std::cout << "└"; for (size_t i = 0; i < widths.size(); ++i) { std::cout << std::string(widths[i], '─'); if (i < widths.size() - 1) std::cout << "┴"; } std::cout << "┘" << std::endl;
+    DisplayHelper::printTableFooter(widths);
     std::cout << std::endl << "共 " << records.size() << " 条记录，总计: " << DisplayHelper::formatAmount(total) << std::endl;
 }
 
-void ReportGenerator::printIncomeByMonth() {
-    DisplayHelper::printSubHeader("收入月度统计");
-    auto records = manager.getAllIncome();
-    if (records.empty()) { DisplayHelper::printInfo("暂无收入记录"); return; }
+void ReportGenerator::printByMonth(const std::string& title, const std::string& column, const std::string& emptyText, const LedgerReport& report) {
+    DisplayHelper::printSubHeader(title);
+    if (report.months.empty()) { DisplayHelper::printInfo(emptyText); return; }
     
-    std::map<std::string, double> monthlyTotals;
-    for (const auto& r : records) monthlyTotals[extractMonth(r.getDate())] += r.getAmount();
-    
-    std::vector<std::string> headers = {"月份", "收入金额"};
+    std::vector<std::string> headers = {"月份", column};
     std::vector<int> widths = {12, 20};
     DisplayHelper::printTableHeader(headers, widths);
     
-    double total = 0.0;
-    for (const auto& p : monthlyTotals) {
-        DisplayHelper::printTableRow({p.first, DisplayHelper::formatAmount(p.second)}, widths);
+    Money total;
+    for (const auto& p : report.months) {
+        DisplayHelper::printTableRow({Date::formatYearMonth(p.first), DisplayHelper::formatAmount(p.second)}, widths);
         total += p.second;
     }
     DisplayHelper::printTableSeparator(widths);
     DisplayHelper::printTableRow({"总计", DisplayHelper::formatAmount(total)}, widths);
-    std::cout << "└"; for (size_t i = 0; i < widths.size(); ++i) { std::cout << std::string(widths[i], '─'); if (i < widths.size() - 1) std::cout << "┴"; } std::cout << "┘" << std::endl;
+    DisplayHelper::printTableFooter(widths);
 }
 
-void ReportGenerator::printIncomeByCategory() {
-    DisplayHelper::printSubHeader("收入分类统计");
-    auto summaries = calculateIncomeCategorySummary();
-    if (summaries.empty()) { DisplayHelper::printInfo("暂无收入记录"); return; }
+void ReportGenerator::printByCategory(const std::string& title, const std::string& emptyText, const LedgerReport& report) {
+    DisplayHelper::printSubHeader(title);
+    if (report.categories.empty()) { DisplayHelper::printInfo(emptyText); return; }
     
     std::vector<std::string> headers = {"分类", "金额", "占比"};
     std::vector<int> widths = {12, 18, 10};
     DisplayHelper::printTableHeader(headers, widths);
     
-    double total = 0.0;
-    for (const auto& s : summaries) {
+    Money total;
+    for (const auto& s : report.categories) {
         DisplayHelper::printTableRow({s.category, DisplayHelper::formatAmount(s.total), DisplayHelper::formatPercentage(s.percentage)}, widths);
         total += s.total;
     }
     DisplayHelper::printTableSeparator(widths);
     DisplayHelper::printTableRow({"总计", DisplayHelper::formatAmount(total), "100.0%"}, widths);
-    std::cout << "└"; for (size_t i = 0; i < widths.size(); ++i) { std::cout << std::string(widths[i], '─'); if (i < widths.size() - 1) std::cout << "┴"; } std::cout << "┘" << std::endl;
+    DisplayHelper::printTableFooter(widths);
+}
+
+void ReportGenerator::printIncomeByMonth() {
+    printByMonth("收入月度统计", "收入金额", "暂无收入记录", ReportEngine(manager).build().income);
+}
+
+void ReportGenerator::printIncomeByCategory() {
+    printByCategory("收入分类统计", "暂无收入记录", ReportEngine(manager).build().income);
 }
 
 void ReportGenerator::printAllExpenseRecords() {
     DisplayHelper::printSubHeader("所有支出记录");
-    auto records = manager.getAllExpense();
+    auto records = manager.viewExpense();
     if (records.empty()) { DisplayHelper::printInfo("暂无支出记录"); return; }
     
     std::vector<std::string> headers = {"ID", "日期", "金额", "分类", "支付对象", "描述"};
     std::vector<int> widths = {6, 12, 14, 10, 12, 20};
     DisplayHelper::printTableHeader(headers, widths);
     
-    double total = 0.0;
+    Money total;
     for (const auto& r : records) {
-        std::vector<std::string> row = {std::to_string(r.getId()), r.getDate(), DisplayHelper::formatAmount(r.getAmount()), r.getCategory(), r.getPayee(), r.getDescription()};
+        std::vector<std::string> row = {std::to_string(r.getId()), r.getDate().toString(), DisplayHelper::formatAmount(r.getAmount()), r.getCategory(), r.getParty(), r.getDescription()};
         DisplayHelper::printTableRow(row, widths);
         total += r.getAmount();
     }
-    std::cout << "└"; for (size_t i = 0; i < widths.size(); ++i) { std::cout << std::string(widths[i], '─'); if (i < widths.size() - 1) std::cout << "┴"; } std::cout << "┘" << std::endl;
+    DisplayHelper::printTableFooter(widths);
     std::cout << std::endl << "共 " << records.size() << " 条记录，总计: " << DisplayHelper::formatAmount(total) << std::endl;
 }
 
 void ReportGenerator::printExpenseByMonth() {
-    DisplayHelper::printSubHeader("支出月度统计");
-    auto records = manager.getAllExpense();
-    if (records.empty()) { DisplayHelper::printInfo("暂无支出记录"); return; }
-    
-    std::map<std::string, double> monthlyTotals;
-    for (const auto& r : records) monthlyTotals[extractMonth(r.getDate())] += r.getAmount();
-    
-    std::vector<std::string> headers = {"月份", "支出金额"};
-    std::vector<int> widths = {12, 20};
-    DisplayHelper::printTableHeader(headers, widths);
-    
-    double total = 0.0;
-    for (const auto& p : monthlyTotals) {
-        DisplayHelper::printTableRow({p.first, DisplayHelper::formatAmount(p.second)}, widths);
-        total += p.second;
-    }
-    DisplayHelper::printTableSeparator(widths);
-    DisplayHelper::printTableRow({"总计", DisplayHelper::formatAmount(total)}, widths);
-    std::cout << "└"; for (size_t i = 0; i < widths.size(); ++i) { std::cout << std::string(widths[i], '─'); if (i < widths.size() - 1) std::cout << "┴"; } std::cout << "┘" << std::endl;
+    printByMonth("支出月度统计", "支出金额", "暂无支出记录", ReportEngine(manager).build().expense);
 }
 
 void ReportGenerator::printExpenseByCategory() {
-    DisplayHelper::printSubHeader("支出分类统计");
-    auto summaries = calculateExpenseCategorySummary();
-    if (summaries.empty()) { DisplayHelper::printInfo("暂无支出记录"); return; }
-    
-    std::vector<std::string> headers = {"分类", "金额", "占比"};
-    std::vector<int> widths = {12, 18, 10};
-    DisplayHelper::printTableHeader(headers, widths);
-    
-    double total = 0.0;
-    for (const auto& s : summaries) {
-        DisplayHelper::printTableRow({s.category, DisplayHelper::formatAmount(s.total), DisplayHelper::formatPercentage(s.percentage)}, widths);
-        total += s.total;
-    }
-    DisplayHelper::printTableSeparator(widths);
-    DisplayHelper::printTableRow({"总计", DisplayHelper::formatAmount(total), "100.0%"}, widths);
-    std::cout << "└"; for (size_t i = 0; i < widths.size(); ++i) { std::cout << std::string(widths[i], '─'); if (i < widths.size() - 1) std::cout << "┴"; } std::cout << "┘" << std::endl;
+    printByCategory("支出分类统计", "暂无支出记录", ReportEngine(manager).build().expense);
 }
 
 void ReportGenerator::printMonthlySummary() {
+    printMonthlySummary(ReportEngine(manager).build());
+}
+
+void ReportGenerator::printMonthlySummary(const FinanceReport& report) {
     DisplayHelper::printSubHeader("月度收支汇总");
-    auto summaries = calculateMonthlySummary();
+    const std::vector<MonthlySummary>& summaries = report.monthly;
     if (summaries.empty()) { DisplayHelper::printInfo("暂无财务记录"); return; }
     
     std::vector<std::string> headers = {"月份", "收入", "支出", "结余"};
     std::vector<int> widths = {10, 16, 16, 16};
     DisplayHelper::printTableHeader(headers, widths);
     
-    double totalIncome = 0.0, totalExpense = 0.0;
+    Money totalIncome, totalExpense;
     for (const auto& s : summaries) {
         DisplayHelper::printTableRow({s.month, DisplayHelper::formatAmount(s.totalIncome), DisplayHelper::formatAmount(s.totalExpense), DisplayHelper::formatAmount(s.netBalance)}, widths);
         totalIncome += s.totalIncome; totalExpense += s.totalExpense;
     }
     DisplayHelper::printTableSeparator(widths);
     DisplayHelper::printTableRow({"总计", DisplayHelper::formatAmount(totalIncome), DisplayHelper::formatAmount(totalExpense), DisplayHelper::formatAmount(totalIncome - totalExpense)}, widths);
-    std::cout << "└"; for (size_t i = 0; i < widths.size(); ++i) { std::cout << std::string(widths[i], '─'); if (i < widths.size() - 1) std::cout << "┴"; } std::cout << "┘" << std::endl;
+    DisplayHelper::printTableFooter(widths);
 }
 
 void ReportGenerator::printCategoryBreakdown() {
+    printCategoryBreakdown(ReportEngine(manager).build());
+}
+
+void ReportGenerator::printCategoryBreakdown(const FinanceReport& report) {
     DisplayHelper::printSubHeader("分类统计");
     std::cout << std::endl << "【收入分类】" << std::endl;
-    printIncomeByCategory();
+    printByCategory("收入分类统计", "暂无收入记录", report.income);
     std::cout << std::endl << "【支出分类】" << std::endl;
-    printExpenseByCategory();
+    printByCategory("支出分类统计", "暂无支出记录", report.expense);
 }
 
 void ReportGenerator::printOverallSummary() {
+    printOverallSummary(ReportEngine(manager).build());
+}
+
+void ReportGenerator::printOverallSummary(const FinanceReport& report) {
     DisplayHelper::printSubHeader("财务总览");
-    double totalIncome = manager.getTotalIncome();
-    double totalExpense = manager.getTotalExpense();
-    double netBalance = manager.getNetBalance();
+    Money totalIncome = report.income.total;
+    Money totalExpense = report.expense.total;
+    Money netBalance = report.getNetBalance();
     
     std::cout << std::endl;
     std::cout << "┌────────────────────────────────────────────┐" << std::endl;
     std::cout << "│              财务统计总览                  │" << std::endl;
     std::cout << "├────────────────────────────────────────────┤" << std::endl;
-    std::cout << "│ 收入记录数:     " << std::setw(25) << std::left << manager.getIncomeCount() << "│" << std::endl;
-    std::cout << "│ 支出记录数:     " << std::setw(25) << std::left << manager.getExpenseCount() << "│" << std::endl;
+    std::cout << "│ 收入记录数:     " << std::setw(25) << std::left << report.income.count << "│" << std::endl;
+    std::cout << "│ 支出记录数:     " << std::setw(25) << std::left << report.expense.count << "│" << std::endl;
     std::cout << "├────────────────────────────────────────────┤" << std::endl;
     std::cout << "│ 总收入:         " << std::setw(25) << std::left << DisplayHelper::formatAmount(totalIncome) << "│" << std::endl;
     std::cout << "│ 总支出:         " << std::setw(25) << std::left << DisplayHelper::formatAmount(totalExpense) << "│" << std::endl;
@@ -189,46 +167,72 @@ void ReportGenerator::printOverallSummary() {
     std::cout << "└────────────────────────────────────────────┘" << std::endl;
     
     std::cout << std::endl;
-    if (netBalance > 0) DisplayHelper::printSuccess("财务状况良好，收入大于支出！");
-    else if (netBalance < 0) DisplayHelper::printWarning("注意：支出大于收入，建议控制开支。");
+    if (netBalance.isPositive()) DisplayHelper::printSuccess("财务状况良好，收入大于支出！");
+    else if (netBalance < Money()) DisplayHelper::printWarning("注意：支出大于收入，建议控制开支。");
     else DisplayHelper::printInfo("收支平衡。");
 }
 
-std::vector<MonthlySummary> ReportGenerator::calculateMonthlySummary() const {
-    std::map<std::string, MonthlySummary> monthlyData;
-    for (const auto& r : manager.getAllIncome()) { auto m = extractMonth(r.getDate()); monthlyData[m].month = m; monthlyData[m].totalIncome += r.getAmount(); }
-    for (const auto& r : manager.getAllExpense()) { auto m = extractMonth(r.getDate()); monthlyData[m].month = m; monthlyData[m].totalExpense += r.getAmount(); }
-    
-    std::vector<MonthlySummary> result;
-    for (auto& p : monthlyData) { p.second.netBalance = p.second.totalIncome - p.second.totalExpense; result.push_back(p.second); }
-    std::sort(result.begin(), result.end(), [](const MonthlySummary& a, const MonthlySummary& b) { return a.month < b.month; });
-    return result;
+void ReportGenerator::printFullReport() {
+    FinanceReport report = ReportEngine(manager).build();
+    printMonthlySummary(report);
+    printCategoryBreakdown(report);
+    printOverallSummary(report);
 }
 
-std::vector<CategorySummary> ReportGenerator::calculateIncomeCategorySummary() const {
-    std::map<std::string, double> categoryTotals;
-    double grandTotal = 0.0;
-    for (const auto& r : manager.getAllIncome()) { categoryTotals[r.getCategory()] += r.getAmount(); grandTotal += r.getAmount(); }
+void ReportGenerator::printFullReport(Date startDate, Date endDate) {
+    FinanceReport report = ReportEngine(manager).build(startDate, endDate);
+    DisplayHelper::printInfo("统计区间: " + startDate.toString() + " ~ " + endDate.toString());
+    printMonthlySummary(report);
+    printCategoryBreakdown(report);
+    printOverallSummary(report);
+}
+
+void ReportGenerator::printDateRangeSummary(Date startDate, Date endDate) {
+    DisplayHelper::printSubHeader("区间收支统计 " + startDate.toString() + " ~ " + endDate.toString());
+    Money income = manager.getIncomeBetween(startDate, endDate);
+    Money expense = manager.getExpenseBetween(startDate, endDate);
     
-    std::vector<CategorySummary> result;
-    for (const auto& p : categoryTotals) {
-        CategorySummary s; s.category = p.first; s.total = p.second; s.percentage = grandTotal > 0 ? (p.second / grandTotal * 100.0) : 0.0;
-        result.push_back(s);
+    std::vector<std::string> headers = {"项目", "金额"};
+    std::vector<int> widths = {16, 20};
+    DisplayHelper::printTableHeader(headers, widths);
+    DisplayHelper::printTableRow({"区间收入", DisplayHelper::formatAmount(income)}, widths);
+    DisplayHelper::printTableRow({"区间支出", DisplayHelper::formatAmount(expense)}, widths);
+    DisplayHelper::printTableRow({"区间结余", DisplayHelper::formatAmount(income - expense)}, widths);
+    DisplayHelper::printTableSeparator(widths);
+    DisplayHelper::printTableRow({"期末结余", DisplayHelper::formatAmount(manager.getBalanceAsOf(endDate))}, widths);
+    DisplayHelper::printTableFooter(widths);
+    
+    // 各分类的区间支出，每个分类一次树状数组查询
+    const std::vector<LedgerTotals::Bucket>& buckets = manager.getExpenseTotals().getCategories();
+    std::vector<CategorySummary> summaries;
+    for (uint32_t id = 0; id < buckets.size(); ++id) {
+        if (buckets[id].count == 0) continue;
+        const std::string& category = StringDictionary::categories().text(id);
+        CategorySummary s; s.category = category; s.total = manager.getExpenseByCategoryBetween(category, startDate, endDate); s.percentage = CategorySummary::percentOf(s.total, expense);
+        if (s.total != Money()) summaries.push_back(s);
     }
-    std::sort(result.begin(), result.end(), [](const CategorySummary& a, const CategorySummary& b) { return a.total > b.total; });
-    return result;
+    if (summaries.empty()) return;
+    std::sort(summaries.begin(), summaries.end(), [](const CategorySummary& a, const CategorySummary& b) {
+        return a.total != b.total ? a.total > b.total : a.category < b.category;
+    });
+    std::cout << std::endl << "【区间支出分类】" << std::endl;
+    headers = {"分类", "金额", "占比"};
+    widths = {12, 18, 10};
+    DisplayHelper::printTableHeader(headers, widths);
+    for (const auto& s : summaries) {
+        DisplayHelper::printTableRow({s.category, DisplayHelper::formatAmount(s.total), DisplayHelper::formatPercentage(s.percentage)}, widths);
+    }
+    DisplayHelper::printTableFooter(widths);
+}
+
+std::vector<MonthlySummary> ReportGenerator::calculateMonthlySummary() const {
+    return ReportEngine(manager).build().monthly;
+}
+
+std::vector<CategorySummary> ReportGenerator::calculateIncomeCategorySummary() const {
+    return ReportEngine(manager).build().income.categories;
 }
 
 std::vector<CategorySummary> ReportGenerator::calculateExpenseCategorySummary() const {
-    std::map<std::string, double> categoryTotals;
-    double grandTotal = 0.0;
-    for (const auto& r : manager.getAllExpense()) { categoryTotals[r.getCategory()] += r.getAmount(); grandTotal += r.getAmount(); }
-    
-    std::vector<CategorySummary> result;
-    for (const auto& p : categoryTotals) {
-        CategorySummary s; s.category = p.first; s.total = p.second; s.percentage = grandTotal > 0 ? (p.second / grandTotal * 100.0) : 0.0;
-        result.push_back(s);
-    }
-    std::sort(result.begin(), result.end(), [](const CategorySummary& a, const CategorySummary& b) { return a.total > b.total; });
-    return result;
+    return ReportEngine(manager).build().expense.categories;
 }
@@ -0,0 +1,407 @@
+#include "SimdKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SIMD_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// GCC/Clang 按函数开启指令集，整个文件仍按默认目标编译；MSVC 不需要标注即可使用这些指令
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SIMD_TARGET(isa)
+#endif
+
+namespace {
+
+typedef LedgerTotals::Bucket Bucket;
+
+// 掩码中最低位1的位置（调用方保证掩码非0）
+inline unsigned lowestSetBit(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+inline void tally(Bucket& bucket, int64_t cents) {
+    bucket.cents += cents;
+    ++bucket.count;
+}
+
+// ---------------- 标量实现，也用于向量实现处理末尾不足一组的部分 ----------------
+
+int64_t sumScalar(const int64_t* amounts, size_t count) {
+    int64_t total = 0;
+    for (size_t i = 0; i < count; ++i) total += amounts[i];
+    return total;
+}
+
+Bucket sumInDateRangeScalar(const uint32_t* dates, const int64_t* amounts, size_t count, uint32_t first, uint32_t last) {
+    Bucket result;
+    for (size_t i = 0; i < count; ++i) {
+        if (dates[i] >= first && dates[i] <= last) tally(result, amounts[i]);
+    }
+    return result;
+}
+
+size_t findAtLeastScalar(const int64_t* amounts, size_t count, int64_t threshold) {
+    for (size_t i = 0; i < count; ++i) {
+        if (amounts[i] >= threshold) return i;
+    }
+    return count;
+}
+
+void histogramScalar(const uint32_t* dates, const int64_t* amounts, const uint32_t* categories, size_t count,
+                     uint32_t first, uint32_t last, Bucket* months, Bucket* categoryBuckets) {
+    uint32_t firstMonth = first / 100;
+    for (size_t i = 0; i < count; ++i) {
+        if (dates[i] < first || dates[i] > last) continue;
+        tally(months[dates[i] / 100 - firstMonth], amounts[i]);
+        tally(categoryBuckets[categories[i]], amounts[i]);
+    }
+}
+
+inline bool isCsvSpecial(char c) {
+    return c == ',' || c == '"' || c == '\n' || c == '\r';
+}
+
+const char* findCsvSpecialScalar(const char* p, const char* end) {
+    while (p < end && !isCsvSpecial(*p)) ++p;
+    return p;
+}
+
+#ifdef SIMD_KERNELS_X86
+
+// 除以100：x * ceil(2^37 / 100) >> 37，对全部32位无符号整数精确
+const int DIV100_MAGIC = 0x51EB851F;
+const int DIV100_SHIFT = 37;
+
+// ---------------- SSE2：每组4个日期、2个金额 ----------------
+
+SIMD_TARGET("sse2")
+int64_t sumSse2(const int64_t* amounts, size_t count) {
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        acc0 = _mm_add_epi64(acc0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(amounts + i)));
+        acc1 = _mm_add_epi64(acc1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(amounts + i + 2)));
+    }
+    int64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), _mm_add_epi64(acc0, acc1));
+    return lanes[0] + lanes[1] + sumScalar(amounts + i, count - i);
+}
+
+// 日期在 [first, last] 内的通道为全1
+SIMD_TARGET("sse2")
+inline __m128i inRangeSse2(__m128i dates, __m128i first, __m128i last) {
+    __m128i outside = _mm_or_si128(_mm_cmpgt_epi32(first, dates), _mm_cmpgt_epi32(dates, last));
+    return _mm_xor_si128(outside, _mm_set1_epi32(-1));
+}
+
+SIMD_TARGET("sse2")
+Bucket sumInDateRangeSse2(const uint32_t* dates, const int64_t* amounts, size_t count, uint32_t first, uint32_t last) {
+    const __m128i lo = _mm_set1_epi32(static_cast<int>(first));
+    const __m128i hi = _mm_set1_epi32(static_cast<int>(last));
+    __m128i cents = _mm_setzero_si128();
+    __m128i hits = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i in = inRangeSse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(dates + i)), lo, hi);
+        // 32位掩码扩展成64位，与金额按位与后累加；掩码为-1，减去它即计数
+        __m128i mask0 = _mm_unpacklo_epi32(in, in);
+        __m128i mask1 = _mm_unpackhi_epi32(in, in);
+        cents = _mm_add_epi64(cents, _mm_and_si128(mask0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(amounts + i))));
+        cents = _mm_add_epi64(cents, _mm_and_si128(mask1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(amounts + i + 2))));
+        hits = _mm_sub_epi64(_mm_sub_epi64(hits, mask0), mask1);
+    }
+    int64_t centLanes[2], hitLanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(centLanes), cents);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(hitLanes), hits);
+    Bucket result = sumInDateRangeScalar(dates + i, amounts + i, count - i, first, last);
+    result.cents += centLanes[0] + centLanes[1];
+    result.count += static_cast<size_t>(hitLanes[0] + hitLanes[1]);
+    return result;
+}
+
+// SSE2 没有64位比较：金额与阈值的差不会溢出，差的符号位即比较结果
+SIMD_TARGET("sse2")
+size_t findAtLeastSse2(const int64_t* amounts, size_t count, int64_t threshold) {
+    const __m128i t = _mm_set1_epi64x(threshold);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i d0 = _mm_sub_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(amounts + i)), t);
+        __m128i d1 = _mm_sub_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(amounts + i + 2)), t);
+        unsigned negative = static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(d0)))
+                          | static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(d1))) << 2;
+        unsigned hit = ~negative & 0xFu;
+        if (hit != 0) return i + lowestSetBit(hit);
+    }
+    return i + findAtLeastScalar(amounts + i, count - i, threshold);
+}
+
+// 4个日期各自除以100：偶数通道直接相乘，奇数通道移到低32位后相乘，再拼回原位
+SIMD_TARGET("sse2")
+inline __m128i div100Sse2(__m128i x) {
+    const __m128i magic = _mm_set1_epi32(DIV100_MAGIC);
+    __m128i even = _mm_srli_epi64(_mm_mul_epu32(x, magic), DIV100_SHIFT);
+    __m128i odd = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(x, 32), magic), DIV100_SHIFT);
+    return _mm_or_si128(even, _mm_slli_epi64(odd, 32));
+}
+
+SIMD_TARGET("sse2")
+void histogramSse2(const uint32_t* dates, const int64_t* amounts, const uint32_t* categories, size_t count,
+                   uint32_t first, uint32_t last, Bucket* months, Bucket* categoryBuckets) {
+    const __m128i lo = _mm_set1_epi32(static_cast<int>(first));
+    const __m128i hi = _mm_set1_epi32(static_cast<int>(last));
+    const __m128i firstMonth = _mm_set1_epi32(static_cast<int>(first / 100));
+    uint32_t index[4];
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dates + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(inRangeSse2(d, lo, hi))));
+        if (mask == 0) continue;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(index), _mm_sub_epi32(div100Sse2(d), firstMonth));
+        for (; mask != 0; mask &= mask - 1) {
+            unsigned lane = lowestSetBit(mask);
+            tally(months[index[lane]], amounts[i + lane]);
+            tally(categoryBuckets[categories[i + lane]], amounts[i + lane]);
+        }
+    }
+    histogramScalar(dates + i, amounts + i, categories + i, count - i, first, last, months, categoryBuckets);
+}
+
+// 每次比较16个字节
+SIMD_TARGET("sse2")
+const char* findCsvSpecialSse2(const char* p, const char* end) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, quote)),
+                                   _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+        if (mask != 0) return p + lowestSetBit(mask);
+        p += 16;
+    }
+    return findCsvSpecialScalar(p, end);
+}
+
+// ---------------- AVX2：每组8个日期、4个金额 ----------------
+
+SIMD_TARGET("avx2")
+int64_t sumAvx2(const int64_t* amounts, size_t count) {
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm256_add_epi64(acc0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(amounts + i)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(amounts + i + 4)));
+    }
+    int64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(acc0, acc1));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumScalar(amounts + i, count - i);
+}
+
+SIMD_TARGET("avx2")
+inline __m256i inRangeAvx2(__m256i dates, __m256i first, __m256i last) {
+    __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(first, dates), _mm256_cmpgt_epi32(dates, last));
+    return _mm256_xor_si256(outside, _mm256_set1_epi32(-1));
+}
+
+SIMD_TARGET("avx2")
+Bucket sumInDateRangeAvx2(const uint32_t* dates, const int64_t* amounts, size_t count, uint32_t first, uint32_t last) {
+    const __m256i lo = _mm256_set1_epi32(static_cast<int>(first));
+    const __m256i hi = _mm256_set1_epi32(static_cast<int>(last));
+    __m256i cents = _mm256_setzero_si256();
+    __m256i hits = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i in = inRangeAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(dates + i)), lo, hi);
+        __m256i mask0 = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(in));
+        __m256i mask1 = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(in, 1));
+        cents = _mm256_add_epi64(cents, _mm256_and_si256(mask0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(amounts + i))));
+        cents = _mm256_add_epi64(cents, _mm256_and_si256(mask1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(amounts + i + 4))));
+        hits = _mm256_sub_epi64(_mm256_sub_epi64(hits, mask0), mask1);
+    }
+    int64_t centLanes[4], hitLanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(centLanes), cents);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(hitLanes), hits);
+    Bucket result = sumInDateRangeScalar(dates + i, amounts + i, count - i, first, last);
+    result.cents += centLanes[0] + centLanes[1] + centLanes[2] + centLanes[3];
+    result.count += static_cast<size_t>(hitLanes[0] + hitLanes[1] + hitLanes[2] + hitLanes[3]);
+    return result;
+}
+
+SIMD_TARGET("avx2")
+size_t findAtLeastAvx2(const int64_t* amounts, size_t count, int64_t threshold) {
+    const __m256i t = _mm256_set1_epi64x(threshold);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i d0 = _mm256_sub_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(amounts + i)), t);
+        __m256i d1 = _mm256_sub_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(amounts + i + 4)), t);
+        unsigned negative = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(d0)))
+                          | static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(d1))) << 4;
+        unsigned hit = ~negative & 0xFFu;
+        if (hit != 0) return i + lowestSetBit(hit);
+    }
+    return i + findAtLeastScalar(amounts + i, count - i, threshold);
+}
+
+SIMD_TARGET("avx2")
+inline __m256i div100Avx2(__m256i x) {
+    const __m256i magic = _mm256_set1_epi32(DIV100_MAGIC);
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(x, magic), DIV100_SHIFT);
+    __m256i odd = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), magic), DIV100_SHIFT);
+    return _mm256_or_si256(even, _mm256_slli_epi64(odd, 32));
+}
+
+SIMD_TARGET("avx2")
+void histogramAvx2(const uint32_t* dates, const int64_t* amounts, const uint32_t* categories, size_t count,
+                   uint32_t first, uint32_t last, Bucket* months, Bucket* categoryBuckets) {
+    const __m256i lo = _mm256_set1_epi32(static_cast<int>(first));
+    const __m256i hi = _mm256_set1_epi32(static_cast<int>(last));
+    const __m256i firstMonth = _mm256_set1_epi32(static_cast<int>(first / 100));
+    uint32_t index[8];
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dates + i));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(inRangeAvx2(d, lo, hi))));
+        if (mask == 0) continue;
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(index), _mm256_sub_epi32(div100Avx2(d), firstMonth));
+        for (; mask != 0; mask &= mask - 1) {
+            unsigned lane = lowestSetBit(mask);
+            tally(months[index[lane]], amounts[i + lane]);
+            tally(categoryBuckets[categories[i + lane]], amounts[i + lane]);
+        }
+    }
+    histogramScalar(dates + i, amounts + i, categories + i, count - i, first, last, months, categoryBuckets);
+}
+
+// 每次比较32个字节，不足32字节的部分交给 SSE2
+SIMD_TARGET("avx2")
+const char* findCsvSpecialAvx2(const char* p, const char* end) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    while (end - p >= 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, comma), _mm256_cmpeq_epi8(v, quote)),
+                                      _mm256_or_si256(_mm256_cmpeq_epi8(v, lf), _mm256_cmpeq_epi8(v, cr)));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+        if (mask != 0) return p + lowestSetBit(mask);
+        p += 32;
+    }
+    return findCsvSpecialSse2(p, end);
+}
+
+#endif // SIMD_KERNELS_X86
+
+// ---------------- 运行时选择 ----------------
+
+struct KernelTable {
+    SimdKernels::Level level;
+    int64_t (*sum)(const int64_t*, size_t);
+    Bucket (*sumInDateRange)(const uint32_t*, const int64_t*, size_t, uint32_t, uint32_t);
+    size_t (*findAtLeast)(const int64_t*, size_t, int64_t);
+    void (*histogram)(const uint32_t*, const int64_t*, const uint32_t*, size_t, uint32_t, uint32_t, Bucket*, Bucket*);
+    const char* (*findCsvSpecial)(const char*, const char*);
+};
+
+// CPU 支持的最高级别（AVX2 还要求操作系统保存 YMM 寄存器）
+SimdKernels::Level detectLevel() {
+#if defined(SIMD_KERNELS_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    bool sse2 = (info[3] & (1 << 26)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+        __cpuidex(info, 7, 0);
+        if ((info[1] & (1 << 5)) != 0) return SimdKernels::Level::AVX2;
+    }
+    return sse2 ? SimdKernels::Level::SSE2 : SimdKernels::Level::Scalar;
+#elif defined(SIMD_KERNELS_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdKernels::Level::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdKernels::Level::SSE2;
+    return SimdKernels::Level::Scalar;
+#else
+    return SimdKernels::Level::Scalar;
+#endif
+}
+
+KernelTable tableFor(SimdKernels::Level level) {
+#ifdef SIMD_KERNELS_X86
+    if (level == SimdKernels::Level::AVX2) {
+        return {level, sumAvx2, sumInDateRangeAvx2, findAtLeastAvx2, histogramAvx2, findCsvSpecialAvx2};
+    }
+    if (level == SimdKernels::Level::SSE2) {
+        return {level, sumSse2, sumInDateRangeSse2, findAtLeastSse2, histogramSse2, findCsvSpecialSse2};
+    }
+#endif
+    return {SimdKernels::Level::Scalar, sumScalar, sumInDateRangeScalar, findAtLeastScalar, histogramScalar,
+            findCsvSpecialScalar};
+}
+
+KernelTable& activeTable() {
+    static KernelTable table = tableFor(detectLevel());
+    return table;
+}
+
+} // namespace
+
+int64_t SimdKernels::sum(const int64_t* amounts, size_t count) {
+    return activeTable().sum(amounts, count);
+}
+
+LedgerTotals::Bucket SimdKernels::sumInDateRange(const uint32_t* dates, const int64_t* amounts, size_t count,
+                                                 uint32_t first, uint32_t last) {
+    if (first > last) return LedgerTotals::Bucket();
+    return activeTable().sumInDateRange(dates, amounts, count, first, last);
+}
+
+size_t SimdKernels::findAtLeast(const int64_t* amounts, size_t count, int64_t threshold) {
+    return activeTable().findAtLeast(amounts, count, threshold);
+}
+
+void SimdKernels::histogram(const uint32_t* dates, const int64_t* amounts, const uint32_t* categories, size_t count,
+                            uint32_t first, uint32_t last, LedgerTotals::Bucket* months, LedgerTotals::Bucket* categoryBuckets) {
+    if (first > last) return;
+    activeTable().histogram(dates, amounts, categories, count, first, last, months, categoryBuckets);
+}
+
+const char* SimdKernels::findCsvSpecial(const char* p, const char* end) {
+    return activeTable().findCsvSpecial(p, end);
+}
+
+SimdKernels::Level SimdKernels::getLevel() {
+    return activeTable().level;
+}
+
+const char* SimdKernels::getLevelName(Level level) {
+    switch (level) {
+        case Level::Scalar: return "标量";
+        case Level::SSE2: return "SSE2";
+        case Level::AVX2: return "AVX2";
+    }
+    return "未知";
+}
+
+SimdKernels::Level SimdKernels::setLevel(Level level) {
+    Level supported = detectLevel();
+    activeTable() = tableFor(level < supported ? level : supported);
+    return activeTable().level;
+}
@@ -0,0 +1,145 @@
+#include "StringDictionary.h"
+
+#include <stdexcept>
+
+const uint32_t StringDictionary::NONE;
+const uint32_t StringDictionary::CAPACITY;
+
+StringDictionary::StringDictionary(const char* const* seed, size_t seedCount,
+                                   int (*predefined)(const char*, size_t))
+    : count(0), predefined(predefined) {
+    for (size_t i = 0; i < MAX_CHUNKS; ++i) chunks[i].store(nullptr, std::memory_order_relaxed);
+    for (size_t i = 0; i < seedCount; ++i) append(seed[i], CategoryHash::length(seed[i]));
+    // 默认构造的记录都引用空串，预先分配好，查找时不必加锁
+    emptyId = append("", 0);
+}
+
+StringDictionary::~StringDictionary() {
+    for (size_t i = 0; i < MAX_CHUNKS; ++i) delete[] chunks[i].load(std::memory_order_relaxed);
+}
+
+StringDictionary& StringDictionary::categories() {
+    // 有意不释放：后台线程在程序退出时仍可能通过记录读取文本
+    static StringDictionary* instance = new StringDictionary(CategoryHash::NAMES, CategoryHash::COUNT, &CategoryHash::find);
+    return *instance;
+}
+
+StringDictionary& StringDictionary::parties() {
+    static StringDictionary* instance = new StringDictionary();
+    return *instance;
+}
+
+uint32_t StringDictionary::hashOf(const char* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+uint32_t StringDictionary::intern(const char* data, size_t size) {
+    uint32_t id = tryIntern(data, size);
+    if (id == NONE) throw std::length_error("StringDictionary: too many distinct strings");
+    return id;
+}
+
+uint32_t StringDictionary::intern(const std::string& text) {
+    return intern(text.data(), text.size());
+}
+
+uint32_t StringDictionary::tryIntern(const char* data, size_t size) {
+    if (size == 0) return emptyId;
+    if (predefined) {
+        int id = predefined(data, size);
+        if (id >= 0) return static_cast<uint32_t>(id);
+    }
+    uint32_t hash = hashOf(data, size);
+    Shard& shard = shards[hash & (SHARD_COUNT - 1)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    uint32_t id = findInShard(shard, hash, data, size);
+    if (id != NONE) return id;
+    id = append(data, size);
+    if (id != NONE) insertIntoShard(shard, hash, id);
+    return id;
+}
+
+uint32_t StringDictionary::tryIntern(const std::string& text) {
+    return tryIntern(text.data(), text.size());
+}
+
+uint32_t StringDictionary::find(const char* data, size_t size) const {
+    if (size == 0) return emptyId;
+    if (predefined) {
+        int id = predefined(data, size);
+        if (id >= 0) return static_cast<uint32_t>(id);
+    }
+    uint32_t hash = hashOf(data, size);
+    const Shard& shard = shards[hash & (SHARD_COUNT - 1)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return findInShard(shard, hash, data, size);
+}
+
+uint32_t StringDictionary::find(const std::string& text) const {
+    return find(text.data(), text.size());
+}
+
+const std::string& StringDictionary::text(uint32_t id) const {
+    return chunks[id >> CHUNK_BITS].load(std::memory_order_acquire)[id & (CHUNK_SIZE - 1)];
+}
+
+uint32_t StringDictionary::size() const {
+    return count.load(std::memory_order_acquire);
+}
+
+uint32_t StringDictionary::findInShard(const Shard& shard, uint32_t hash, const char* data, size_t size) const {
+    if (shard.slots.empty()) return NONE;
+    size_t mask = shard.slots.size() - 1;
+    // 分片由哈希的低位选出，表内用高位定位，避免同一分片的键挤在一起
+    for (size_t i = (hash >> SHARD_BITS) & mask;; i = (i + 1) & mask) {
+        const Slot& slot = shard.slots[i];
+        if (slot.id == NONE) return NONE;
+        if (slot.hash == hash) {
+            const std::string& entry = text(slot.id);
+            if (entry.size() == size && entry.compare(0, size, data, size) == 0) return slot.id;
+        }
+    }
+}
+
+void StringDictionary::insertIntoShard(Shard& shard, uint32_t hash, uint32_t id) {
+    // 装载率超过一半时容量翻倍
+    if ((shard.used + 1) * 2 > shard.slots.size()) {
+        std::vector<Slot> old;
+        old.swap(shard.slots);
+        Slot empty = {0, NONE};
+        shard.slots.assign(old.empty() ? 16 : old.size() * 2, empty);
+        shard.used = 0;
+        for (const auto& slot : old) {
+            if (slot.id != NONE) insertIntoShard(shard, slot.hash, slot.id);
+        }
+    }
+    size_t mask = shard.slots.size() - 1;
+    size_t i = (hash >> SHARD_BITS) & mask;
+    while (shard.slots[i].id != NONE) i = (i + 1) & mask;
+    shard.slots[i].hash = hash;
+    shard.slots[i].id = id;
+    ++shard.used;
+}
+
+uint32_t StringDictionary::append(const char* data, size_t size) {
+    // 已满时不再递增，count 始终不超过 CAPACITY
+    uint32_t id = count.load(std::memory_order_acquire);
+    do {
+        if (id >= CAPACITY) return NONE;
+    } while (!count.compare_exchange_weak(id, id + 1, std::memory_order_acq_rel));
+    std::atomic<std::string*>& chunk = chunks[id >> CHUNK_BITS];
+    std::string* entries = chunk.load(std::memory_order_acquire);
+    if (!entries) {
+        // 多个分片可能同时需要同一个新块，只保留第一个装入的
+        std::string* fresh = new std::string[CHUNK_SIZE];
+        if (chunk.compare_exchange_strong(entries, fresh, std::memory_order_acq_rel)) entries = fresh;
+        else delete[] fresh;
+    }
+    entries[id & (CHUNK_SIZE - 1)].assign(data, size);
+    return id;
+}
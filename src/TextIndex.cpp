@@ -0,0 +1,138 @@
+#include "TextIndex.h"
+#include <algorithm>
+
+// 解码一个 UTF-8 字符并前移 p；不合法的字节按单字节字符处理
+static uint32_t nextChar(const unsigned char*& p, const unsigned char* end) {
+    unsigned char lead = *p++;
+    if (lead < 0x80) return lead;
+    size_t extra = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+    if (extra == 0 || static_cast<size_t>(end - p) < extra) return lead;
+    uint32_t code = lead & (0x3F >> extra);
+    for (size_t i = 0; i < extra; ++i) {
+        if ((p[i] & 0xC0) != 0x80) return lead;
+        code = (code << 6) | (p[i] & 0x3F);
+    }
+    p += extra;
+    return code;
+}
+
+// 依次把文本中的每个二元组（可能重复）交给 visit
+template <typename Visit>
+static void forEachGram(const std::string& text, Visit visit) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+    const unsigned char* end = p + text.size();
+    if (p == end) return;
+    uint64_t previous = nextChar(p, end);
+    while (p < end) {
+        uint64_t current = nextChar(p, end);
+        // 码点不超过 21 位，两个拼成一个键
+        visit((previous << 21) | current);
+        previous = current;
+    }
+}
+
+void TextIndex::collectGrams(const std::string& text, std::vector<uint64_t>& grams) {
+    grams.clear();
+    forEachGram(text, [&grams](uint64_t gram) { grams.push_back(gram); });
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+}
+
+const size_t TextIndex::CACHE_SIZE;
+
+TextIndex::TextIndex() {
+    resetCache();
+}
+
+void TextIndex::resetCache() {
+    for (CacheEntry& entry : cache) entry.list = nullptr;
+}
+
+void TextIndex::clear() {
+    postings.clear();
+    resetCache();
+}
+
+void TextIndex::add(int id, const std::string& text) {
+    std::vector<uint64_t> grams;
+    collectGrams(text, grams);
+    for (uint64_t gram : grams) {
+        std::vector<int>& list = postings[gram];
+        // 新记录的ID通常最大，直接追加
+        if (list.empty() || list.back() < id) {
+            list.push_back(id);
+        } else {
+            auto it = std::lower_bound(list.begin(), list.end(), id);
+            if (it == list.end() || *it != id) list.insert(it, id);
+        }
+    }
+}
+
+void TextIndex::remove(int id, const std::string& text) {
+    std::vector<uint64_t> grams;
+    collectGrams(text, grams);
+    for (uint64_t gram : grams) {
+        auto found = postings.find(gram);
+        if (found == postings.end()) continue;
+        std::vector<int>& list = found->second;
+        auto it = std::lower_bound(list.begin(), list.end(), id);
+        if (it != list.end() && *it == id) list.erase(it);
+        if (list.empty()) {
+            postings.erase(found);
+            resetCache();
+        }
+    }
+}
+
+void TextIndex::append(int id, const std::string& text) {
+    // 同一文本中重复的二元组只需看倒排表末尾是否已是该ID
+    forEachGram(text, [this, id](uint64_t gram) {
+        CacheEntry& entry = cache[(gram * 0x9E3779B97F4A7C15ull) >> 56];
+        if (!entry.list || entry.gram != gram) {
+            entry.gram = gram;
+            entry.list = &postings[gram];
+        }
+        std::vector<int>& list = *entry.list;
+        if (list.empty() || list.back() != id) list.push_back(id);
+    });
+}
+
+void TextIndex::finish() {
+    resetCache();
+    for (auto& entry : postings) {
+        std::vector<int>& list = entry.second;
+        if (!std::is_sorted(list.begin(), list.end())) std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+        list.shrink_to_fit();
+    }
+}
+
+bool TextIndex::candidates(const std::string& keyword, std::vector<int>& ids) const {
+    ids.clear();
+    std::vector<uint64_t> grams;
+    collectGrams(keyword, grams);
+    if (grams.empty()) return false;
+
+    // 从最短的倒排表开始求交，候选集只会越来越小
+    std::vector<const std::vector<int>*> lists;
+    for (uint64_t gram : grams) {
+        auto found = postings.find(gram);
+        if (found == postings.end()) return true;
+        lists.push_back(&found->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<int>* a, const std::vector<int>* b) { return a->size() < b->size(); });
+    ids = *lists[0];
+    for (size_t i = 1; i < lists.size() && !ids.empty(); ++i) {
+        const std::vector<int>& list = *lists[i];
+        auto from = list.begin();
+        size_t kept = 0;
+        for (int id : ids) {
+            from = std::lower_bound(from, list.end(), id);
+            if (from == list.end()) break;
+            if (*from == id) ids[kept++] = id;
+        }
+        ids.resize(kept);
+    }
+    return true;
+}
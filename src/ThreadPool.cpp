@@ -0,0 +1,78 @@
+#include "ThreadPool.h"
+
+const size_t ThreadPool::PARALLEL_GRAIN;
+
+// 当前线程是否正在执行线程池任务，用于识别嵌套调用
+static thread_local bool insideTask = false;
+
+ThreadPool::ThreadPool(unsigned threads)
+    : job(nullptr), jobTasks(0), nextTask(0), busyWorkers(0), generation(0), stopping(false) {
+    for (unsigned i = 1; i < threads; ++i) workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+// 不断领取下一个任务编号直到领完
+void ThreadPool::drain(const std::function<void(size_t)>& task, size_t tasks) {
+    insideTask = true;
+    for (size_t i = nextTask.fetch_add(1); i < tasks; i = nextTask.fetch_add(1)) task(i);
+    insideTask = false;
+}
+
+void ThreadPool::workerLoop() {
+    uint64_t seen = 0;
+    for (;;) {
+        const std::function<void(size_t)>* task;
+        size_t tasks;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            task = job;
+            tasks = jobTasks;
+        }
+        drain(*task, tasks);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busyWorkers == 0) finished.notify_one();
+        }
+    }
+}
+
+void ThreadPool::run(size_t tasks, const std::function<void(size_t)>& task) {
+    if (tasks == 0) return;
+    if (tasks == 1 || workers.empty() || insideTask) {
+        for (size_t i = 0; i < tasks; ++i) task(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> serial(runMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &task;
+        jobTasks = tasks;
+        nextTask.store(0);
+        busyWorkers = workers.size();
+        ++generation;
+    }
+    wake.notify_all();
+    drain(task, tasks);
+
+    // 每个工作线程都要确认过本批任务，下一批才能开始
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&]() { return busyWorkers == 0; });
+    job = nullptr;
+}
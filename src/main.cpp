@@ -41,11 +41,32 @@ void showWelcome() {
     std::cout << "  正在加载数据..." << std::endl;
 }
 
-int main() {
+// 列出加载时因格式错误跳过的行（最多显示前几条）
+void showLoadIssues(const FinanceManager& manager) {
+    const size_t MAX_SHOWN = 5;
+    size_t skipped = manager.getSkippedRowCount();
+    if (skipped == 0) return;
+    DisplayHelper::printWarning("有 " + std::to_string(skipped) + " 行数据格式错误，已跳过：");
+    std::vector<LoadIssue> issues = manager.getLoadIssues();
+    for (size_t i = 0; i < issues.size() && i < MAX_SHOWN; ++i) {
+        std::cout << "  - " << issues[i].file << " 第" << issues[i].line << "行第" << issues[i].column << "列："
+                  << NumberParser::describe(issues[i].status) << std::endl;
+    }
+    if (skipped > MAX_SHOWN) std::cout << "  ..." << std::endl;
+}
+
+int main(int argc, char* argv[]) {
     initConsole();
+
+    // --partitioned：按月分区存储（数据目录迁移后会一直保持分区布局）
+    StorageOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--partitioned") options.layout = StorageLayout::MonthPartitioned;
+    }
+
     showWelcome();
     
-    FinanceManager manager;
+    FinanceManager manager("data/income.csv", "data/expense.csv", options);
     
     if (!manager.initialize()) {
         DisplayHelper::printMessage("警告：数据加载失败，将使用空数据开始。", true);
@@ -54,6 +75,7 @@ int main() {
         std::cout << "  - 收入记录: " << manager.getIncomeCount() << " 条" << std::endl;
         std::cout << "  - 支出记录: " << manager.getExpenseCount() << " 条" << std::endl;
     }
+    showLoadIssues(manager);
     
     std::cout << std::endl << "  按回车键进入系统...";
     std::cin.get();